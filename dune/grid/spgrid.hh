@@ -27,9 +27,9 @@ namespace Dune
     // TwistUtility for SPGrid
     // -----------------------
 
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct TwistUtility< SPGrid< ct, dim, Ref, Comm > >
-      : public TwistFreeTwistUtility< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct TwistUtility< SPGrid< ct, dim, Ref, Comm, Index > >
+      : public TwistFreeTwistUtility< SPGrid< ct, dim, Ref, Comm, Index > >
     {};
 
   } // end namespace Fem
@@ -33,10 +33,10 @@ namespace Dune
    *
    *  \tparam  Grid  type of grid
    */
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  struct BackupRestoreFacility< SPGrid< ct, dim, Ref, Comm > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  struct BackupRestoreFacility< SPGrid< ct, dim, Ref, Comm, Index > >
   {
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
     typedef typename Grid::Communication Communication;
 
@@ -32,8 +32,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct hasSingleGeometryType< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct hasSingleGeometryType< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief all elements in \ref Dune::SPGrid "SPGrid" have the same
        *         geometry type */
@@ -55,8 +55,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct isCartesian< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct isCartesian< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" is a Cartesian grid */
       static const bool v = true;
@@ -67,8 +67,8 @@ namespace Dune
      *  \tparam  Grid   grid for which the information is desired
      *  \tparam  codim  codimension in question
      */
-    template< class ct, int dim, template< int > class Ref, class Comm, int codim >
-    struct hasEntity< SPGrid< ct, dim, Ref, Comm >, codim >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index, int codim >
+    struct hasEntity< SPGrid< ct, dim, Ref, Comm, Index >, codim >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" implements entities for all
        *         codimensions */
@@ -80,9 +80,9 @@ namespace Dune
      *  \tparam  Grid   grid for which the information is desired
      *  \tparam  codim  codimension in question
      */
-    template< class ct, int dim, template< int > class Ref, class Comm, int codim >
-    struct hasEntityIterator< SPGrid< ct, dim, Ref, Comm >, codim >
-     : public hasEntity< SPGrid< ct, dim, Ref, Comm >, codim >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index, int codim >
+    struct hasEntityIterator< SPGrid< ct, dim, Ref, Comm, Index >, codim >
+     : public hasEntity< SPGrid< ct, dim, Ref, Comm, Index >, codim >
     {
     };
 
@@ -95,8 +95,8 @@ namespace Dune
      *  \note In order to communicate on a given codimension, the grid has to
      *        implement entities for that codimension.
      */
-    template< class ct, int dim, template< int > class Ref, int codim >
-    struct canCommunicate< SPGrid< ct, dim, Ref, MPI_Comm >, codim >
+    template< class ct, int dim, template< int > class Ref, class Index, int codim >
+    struct canCommunicate< SPGrid< ct, dim, Ref, MPI_Comm, Index >, codim >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" with MPI_Comm can communicate on
        *         all codimensions */
@@ -108,8 +108,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct isLevelwiseConforming< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct isLevelwiseConforming< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief All levels of a \ref Dune::SPGrid "SPGrid" are always conform */
       static const bool v = true;
@@ -119,8 +119,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct isLeafwiseConforming< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct isLeafwiseConforming< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief The leaf level of a \ref Dune::SPGrid "SPGrid" are always conform */
       static const bool v = true;
@@ -130,8 +130,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct hasBackupRestoreFacilities< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct hasBackupRestoreFacilities< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" provides backup and restore facilities */
       static const bool v = true;
@@ -141,8 +141,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct threadSafe< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct threadSafe< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" is not thread safe */
       static const bool v = false;
@@ -152,8 +152,8 @@ namespace Dune
      *
      *  \tparam  Grid  grid for which the information is desired
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct viewThreadSafe< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct viewThreadSafe< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" is not thread safe */
       static const bool v = true;
@@ -167,8 +167,8 @@ namespace Dune
     template< class Grid >
     struct hasHierarchicIndexSet;
 
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct hasHierarchicIndexSet< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct hasHierarchicIndexSet< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       static const bool v = true;
     };
@@ -183,8 +183,8 @@ namespace Dune
      *
      *  \note This is not a standard dune-grid capability.
      */
-    template< class ct, int dim, template< int > class Ref, class Comm >
-    struct supportsCallbackAdaptation< SPGrid< ct, dim, Ref, Comm > >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+    struct supportsCallbackAdaptation< SPGrid< ct, dim, Ref, Comm, Index > >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" supports callback adaptation */
       static const bool v = true;
@@ -205,8 +205,8 @@ namespace Dune
      *  \tparam  Grid   grid for which the information is desired
      *  \tparam  codim  codimension in question
      */
-    template< class ct, int dim, template< int > class Ref, class Comm, int codim >
-    struct SuperEntityIterator< SPGrid< ct, dim, Ref, Comm >, codim >
+    template< class ct, int dim, template< int > class Ref, class Comm, class Index, int codim >
+    struct SuperEntityIterator< SPGrid< ct, dim, Ref, Comm, Index >, codim >
     {
       /** \brief \ref Dune::SPGrid "SPGrid" supports superentity iterators for all
        *         codimensions */
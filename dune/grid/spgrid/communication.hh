@@ -1,11 +1,23 @@
 #ifndef DUNE_SPGRID_COMMUNICATION_HH
 #define DUNE_SPGRID_COMMUNICATION_HH
 
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
+#include <dune/common/exceptions.hh>
 #include <dune/common/hybridutilities.hh>
 #include <dune/common/parallel/communication.hh>
 #include <dune/common/parallel/mpicommunication.hh>
 #include <dune/common/parallel/mpitraits.hh>
-#include <dune/common/visibility.hh>
 
 #include <dune/grid/common/exceptions.hh>
 #include <dune/grid/common/datahandleif.hh>
@@ -34,6 +46,12 @@ namespace Dune
     {
       return Communication();
     }
+
+    static Communication duplicate ( const Communication &comm ) { return comm; }
+
+    static void free ( Communication &comm ) {}
+
+    static int maxTag ( const Communication &comm ) { return 32767; }
   };
 
 #if HAVE_MPI
@@ -51,21 +69,302 @@ namespace Dune
     {
       return comm( MPI_COMM_WORLD );
     }
+
+    static Communication duplicate ( const Communication &comm )
+    {
+      MPI_Comm mpiComm;
+      MPI_Comm_dup( comm, &mpiComm );
+      return Communication( mpiComm );
+    }
+
+    static void free ( Communication &comm )
+    {
+      int finalized = 0;
+      MPI_Finalized( &finalized );
+      if( finalized )
+        return;
+      MPI_Comm mpiComm = comm;
+      MPI_Comm_free( &mpiComm );
+    }
+
+    static int maxTag ( const Communication &comm )
+    {
+      int *value = nullptr;
+      int flag = 0;
+      MPI_Comm_get_attr( comm, MPI_TAG_UB, &value, &flag );
+      return (flag ? *value : 32767);
+    }
   };
 #endif // #if HAVE_MPI
 
 
 
-  namespace __SPGrid
+  // SPTagAllocator
+  // --------------
+
+  /**
+   * \brief thread-safe allocator of message tags
+   *
+   * The range [minTag, maxTag] is split into two parts. Transient tags, held
+   * by a single communication, are handed out in cyclic order from the lower
+   * part, so that all processes obtain the same tag for the same
+   * communication as long as communications are set up in the same order
+   * everywhere. Persistent tags, held by long-lived objects like
+   * communication plans, are taken from the upper part, counting down from
+   * maxTag, so they never block the cycle of transient tags.
+   *
+   * A tag remains reserved until it is released. Allocating a tag still in
+   * flight raises an exception instead of silently reusing it; the cycle
+   * advances nonetheless.
+   */
+  class SPTagAllocator
   {
+    typedef SPTagAllocator This;
+
+  public:
+    enum Lifetime { transient, persistent };
+
+    /** \brief maximum number of persistent tags */
+    static const int maxPersistent = 1024;
+
+    SPTagAllocator ( int minTag, int maxTag )
+      : minTag_( minTag ), maxTag_( maxTag ),
+        minPersistent_( maxTag - std::min( int( maxPersistent ), (maxTag - minTag + 1) / 4 ) + 1 ),
+        next_( minTag )
+    {
+      assert( minTag_ < minPersistent_ );
+    }
+
+    SPTagAllocator ( const This & ) = delete;
+
+    This &operator= ( const This & ) = delete;
 
-    DUNE_EXPORT inline int getCommTag ()
+    int allocate ( Lifetime lifetime = transient )
     {
-      static unsigned char counter = 0;
-      return int( counter++ ) + 1536;
+      std::lock_guard< std::mutex > guard( mutex_ );
+      if( lifetime == persistent )
+      {
+        for( int tag = maxTag_; tag >= minPersistent_; --tag )
+        {
+          if( inFlight_.insert( tag ).second )
+            return tag;
+        }
+        DUNE_THROW( InvalidStateException, "All " << (maxTag_ - minPersistent_ + 1) << " persistent message tags in use." );
+      }
+
+      const int tag = next_;
+      next_ = (next_+1 < minPersistent_ ? next_+1 : minTag_);
+      if( !inFlight_.insert( tag ).second )
+        DUNE_THROW( InvalidStateException, "Message tag " << tag << " still in use (" << inFlight_.size() << " communications in flight)." );
+      return tag;
+    }
+
+    void release ( int tag )
+    {
+      std::lock_guard< std::mutex > guard( mutex_ );
+      inFlight_.erase( tag );
+    }
+
+    /** \brief number of tags currently in flight */
+    std::size_t inFlight () const
+    {
+      std::lock_guard< std::mutex > guard( mutex_ );
+      return inFlight_.size();
     }
 
-  } // namespace __SPGrid
+    int minTag () const { return minTag_; }
+    int maxTag () const { return maxTag_; }
+
+    /** \brief number of transient tags, i.e., the length of their cycle */
+    int transientTags () const { return minPersistent_ - minTag_; }
+
+  private:
+    mutable std::mutex mutex_;
+    int minTag_, maxTag_, minPersistent_, next_;
+    std::set< int > inFlight_;
+  };
+
+
+
+  // SPCommTag
+  // ---------
+
+  /** \brief message tag reserved from an SPTagAllocator until released or destroyed */
+  class SPCommTag
+  {
+    typedef SPCommTag This;
+
+  public:
+    SPCommTag () = default;
+
+    explicit SPCommTag ( SPTagAllocator &allocator, SPTagAllocator::Lifetime lifetime = SPTagAllocator::transient )
+      : allocator_( &allocator ), tag_( allocator.allocate( lifetime ) )
+    {}
+
+    SPCommTag ( const This & ) = delete;
+
+    SPCommTag ( This &&other ) : allocator_( other.allocator_ ), tag_( other.tag_ ) { other.allocator_ = nullptr; }
+
+    ~SPCommTag () { release(); }
+
+    This &operator= ( const This & ) = delete;
+
+    This &operator= ( This &&other )
+    {
+      release();
+      allocator_ = other.allocator_;
+      tag_ = other.tag_;
+      other.allocator_ = nullptr;
+      return *this;
+    }
+
+    operator int () const { return tag_; }
+
+    void release ()
+    {
+      if( allocator_ )
+        allocator_->release( tag_ );
+      allocator_ = nullptr;
+    }
+
+  private:
+    SPTagAllocator *allocator_ = nullptr;
+    int tag_ = 0;
+  };
+
+
+
+  // SPProgressThread
+  // ----------------
+
+  /**
+   * \brief background thread driving the progress of point-to-point messages
+   *
+   * Each grid owns one progress thread for its message communicator, shared
+   * by all communications. The thread is started by the first communication
+   * acquiring it and parks on a condition variable while no communication
+   * needs progress. Otherwise, it probes the communicator, which lets the MPI
+   * library advance pending transfers while the application computes. Between
+   * unsuccessful probes, it sleeps with exponential backoff (up to maxBackoff)
+   * to leave the cores to the compute threads. The thread neither completes
+   * requests nor touches any message data; unpacking is left to the thread
+   * owning the communication.
+   *
+   * Background progress requires MPI_THREAD_MULTIPLE; in serial, it is never
+   * available.
+   */
+  template< class Communication >
+  class SPProgressThread;
+
+  template< class C >
+  class SPProgressThread< Communication< C > >
+  {
+  public:
+    explicit SPProgressThread ( const Communication< C > &comm ) {}
+
+    bool acquire () { return false; }
+    void release () {}
+
+    bool active () const { return false; }
+  };
+
+#if HAVE_MPI
+  template<>
+  class SPProgressThread< Communication< MPI_Comm > >
+  {
+    typedef SPProgressThread< Communication< MPI_Comm > > This;
+
+  public:
+    static constexpr std::chrono::microseconds minBackoff{ 1 };
+    static constexpr std::chrono::microseconds maxBackoff{ 100 };
+
+    explicit SPProgressThread ( const Communication< MPI_Comm > &comm ) : comm_( comm ) {}
+
+    SPProgressThread ( const This & ) = delete;
+
+    ~SPProgressThread ()
+    {
+      {
+        std::lock_guard< std::mutex > guard( mutex_ );
+        stop_ = true;
+      }
+      wakeUp_.notify_all();
+      if( thread_.joinable() )
+        thread_.join();
+    }
+
+    This &operator= ( const This & ) = delete;
+
+    /**
+     * \brief register a communication requiring progress
+     *
+     * \returns whether background progress is available
+     */
+    bool acquire ()
+    {
+      std::lock_guard< std::mutex > guard( mutex_ );
+      int provided = MPI_THREAD_SINGLE;
+      MPI_Query_thread( &provided );
+      if( provided < MPI_THREAD_MULTIPLE )
+        return false;
+
+      if( users_++ == 0 )
+        wakeUp_.notify_all();
+      if( !thread_.joinable() )
+        thread_ = std::thread( [ this ] () { run(); } );
+      return true;
+    }
+
+    /** \brief unregister a communication that acquired the progress thread */
+    void release ()
+    {
+      std::lock_guard< std::mutex > guard( mutex_ );
+      assert( users_ > 0 );
+      --users_;
+    }
+
+    /** \brief whether the thread currently drives progress */
+    bool active () const
+    {
+      std::lock_guard< std::mutex > guard( mutex_ );
+      return (users_ > 0);
+    }
+
+  private:
+    void run ()
+    {
+      std::chrono::microseconds backoff = minBackoff;
+      while( true )
+      {
+        {
+          std::unique_lock< std::mutex > lock( mutex_ );
+          if( users_ == 0 )
+            backoff = minBackoff;
+          wakeUp_.wait( lock, [ this ] () { return stop_ || (users_ > 0); } );
+          if( stop_ )
+            return;
+        }
+
+        int flag = 0;
+        MPI_Iprobe( MPI_ANY_SOURCE, MPI_ANY_TAG, comm_, &flag, MPI_STATUS_IGNORE );
+        if( flag )
+          backoff = minBackoff;
+        else
+        {
+          std::this_thread::sleep_for( backoff );
+          backoff = std::min( 2*backoff, maxBackoff );
+        }
+      }
+    }
+
+    MPI_Comm comm_;
+    mutable std::mutex mutex_;
+    std::condition_variable wakeUp_;
+    std::size_t users_ = 0;
+    bool stop_ = false;
+    std::thread thread_;
+  };
+#endif // #if HAVE_MPI
 
 
 
@@ -101,17 +400,37 @@ namespace Dune
 
     void wait ();
 
+    /**
+     * \brief scatter all messages that have arrived so far
+     *
+     * \returns whether the communication is complete
+     */
+    bool test ();
+
+    /**
+     * \brief let the grid's progress thread drive the message transfer until
+     *        the communication completes
+     *
+     * \returns whether background progress is available
+     */
+    bool startProgress ();
+
     [[deprecated]]
     bool pending () const { return !ready(); }
   private:
+    void unpack ( ReadBuffer &buffer );
+    void finish ();
+
     const GridLevel &gridLevel_;
     DataHandle &dataHandle_;
     const Interface *interface_;
     CommunicationDirection dir_;
-    int tag_;
+    SPCommTag tag_;
     bool fixedSize_;
+    std::size_t unpacked_;
     std::vector< WriteBuffer > writeBuffers_;
     std::vector< ReadBuffer > readBuffers_;
+    bool progress_;
   };
 
 
@@ -127,8 +446,10 @@ namespace Dune
       dataHandle_( dataHandle ),
       interface_( &gridLevel.commInterface( iftype ) ),
       dir_( dir ),
-      tag_( __SPGrid::getCommTag() ),
-      fixedSize_( true )
+      tag_( gridLevel.grid().tagAllocator() ),
+      fixedSize_( true ),
+      unpacked_( 0 ),
+      progress_( false )
   {
     for( int codim = 0; codim <= dimension; ++codim )
       fixedSize_ &= !dataHandle_.contains( dimension, codim ) || dataHandle_.fixedSize( dimension, codim );
@@ -140,7 +461,7 @@ namespace Dune
     {
       for( typename Interface::Iterator it = interface_->begin(); it != interface_->end(); ++it )
       {
-        readBuffers_.emplace_back( gridLevel.grid().comm() );
+        readBuffers_.emplace_back( gridLevel.grid().messageComm(), gridLevel.bufferPool() );
         std::size_t size = 0;
         const PartitionList &partitionList = it->receiveList( dir );
         Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, &size ] ( auto codim ) {
@@ -161,7 +482,7 @@ namespace Dune
     writeBuffers_.reserve( numLinks );
     for( typename Interface::Iterator it = interface_->begin(); it != interface_->end(); ++it )
     {
-      writeBuffers_.emplace_back( gridLevel.grid().comm() );
+      writeBuffers_.emplace_back( gridLevel.grid().messageComm(), gridLevel.bufferPool(), it->rank() );
       const PartitionList &partitionList = it->sendList( dir );
       Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList ] ( auto codim ) {
           typedef SPPartitionIterator< codim, const Grid > Iterator;
@@ -199,12 +520,15 @@ namespace Dune
       dataHandle_( other.dataHandle_ ),
       interface_( other.interface_ ),
       dir_( other.dir_ ),
-      tag_( other.tag_ ),
+      tag_( std::move( other.tag_ ) ),
       fixedSize_( other.fixedSize_ ),
+      unpacked_( other.unpacked_ ),
       writeBuffers_( std::move( other.writeBuffers_ ) ),
-      readBuffers_( std::move( other.readBuffers_ ) )
+      readBuffers_( std::move( other.readBuffers_ ) ),
+      progress_( other.progress_ )
   {
     other.interface_ = nullptr;
+    other.progress_ = false;
   }
 
 
@@ -218,60 +542,129 @@ namespace Dune
 
     if( !fixedSize_ )
     {
-      for( std::size_t i = 0; i < numLinks; ++i )
+      while( readBuffers_.size() < numLinks )
       {
-        readBuffers_.emplace_back( gridLevel_.grid().comm() );
+        readBuffers_.emplace_back( gridLevel_.grid().messageComm(), gridLevel_.bufferPool() );
         readBuffers_.back().receive( tag_ );
       }
     }
 
-    for( std::size_t i = 0; i < numLinks; ++i )
+    for( ; unpacked_ < numLinks; ++unpacked_ )
+      unpack( *waitAny( readBuffers_ ) );
+
+    for( typename std::vector< WriteBuffer >::iterator it = writeBuffers_.begin(); it != writeBuffers_.end(); ++it )
+      it->wait();
+
+    finish();
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline bool SPCommunication< Grid, DataHandle >::test ()
+  {
+    if( ready() )
+      return true;
+
+    const std::size_t numLinks = interface_->size();
+
+    // for variable size, only post receives for messages that have arrived
+    if( !fixedSize_ )
     {
-      const typename std::vector< ReadBuffer >::iterator buffer = waitAny( readBuffers_ );
-      for( typename Interface::Iterator it = interface_->begin(); it != interface_->end(); ++it )
+      while( readBuffers_.size() < numLinks )
       {
-        if( it->rank() == buffer->rank() )
+        readBuffers_.emplace_back( gridLevel_.grid().messageComm(), gridLevel_.bufferPool() );
+        if( !readBuffers_.back().tryReceive( tag_ ) )
         {
-          const PartitionList &partitionList = it->receiveList( dir_ );
-          Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, buffer ] ( auto codim ) {
-              typedef SPPartitionIterator< codim, const Grid > Iterator;
-
-              if( !dataHandle_.contains( dimension, codim ) )
-                return;
-
-              const bool fixedSize = dataHandle_.fixedSize( dimension, codim );
-              const Iterator end( gridLevel_, partitionList, typename Iterator::End() );
-              for( Iterator it( gridLevel_, partitionList, typename Iterator::Begin() ); it != end; ++it )
-              {
-                const auto &entity = *it;
-
-                int size;
-                if( !fixedSize )
-                  buffer->read( size );
-                else
-                  size = dataHandle_.size( entity );
+          readBuffers_.pop_back();
+          break;
+        }
+      }
+    }
+
+    for( std::size_t index : testSome( readBuffers_ ) )
+    {
+      unpack( readBuffers_[ index ] );
+      ++unpacked_;
+    }
+    if( unpacked_ < numLinks )
+      return false;
+
+    for( WriteBuffer &buffer : writeBuffers_ )
+    {
+      if( !buffer.test() )
+        return false;
+    }
+
+    finish();
+    return true;
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline bool SPCommunication< Grid, DataHandle >::startProgress ()
+  {
+    if( ready() )
+      return false;
+    if( !progress_ )
+      progress_ = gridLevel_.grid().progressThread().acquire();
+    return progress_;
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunication< Grid, DataHandle >::unpack ( ReadBuffer &buffer )
+  {
+    for( typename Interface::Iterator it = interface_->begin(); it != interface_->end(); ++it )
+    {
+      if( it->rank() == buffer.rank() )
+      {
+        const PartitionList &partitionList = it->receiveList( dir_ );
+        Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, &buffer ] ( auto codim ) {
+            typedef SPPartitionIterator< codim, const Grid > Iterator;
+
+            if( !dataHandle_.contains( dimension, codim ) )
+              return;
+
+            const bool fixedSize = dataHandle_.fixedSize( dimension, codim );
+            const Iterator end( gridLevel_, partitionList, typename Iterator::End() );
+            for( Iterator it( gridLevel_, partitionList, typename Iterator::Begin() ); it != end; ++it )
+            {
+              const auto &entity = *it;
+
+              int size;
+              if( !fixedSize )
+                buffer.read( size );
+              else
+                size = dataHandle_.size( entity );
 #ifndef NDEBUG
-                const std::size_t posBeforeGather = buffer->position();
+              const std::size_t posBeforeGather = buffer.position();
 #endif // #ifndef NDEBUG
-                dataHandle_.scatter( *buffer, entity, size );
+              dataHandle_.scatter( buffer, entity, size );
 #ifndef NDEBUG
-                const std::size_t posAfterGather = buffer->position();
-                const std::size_t sizeInBytes = static_cast< std::size_t >( size ) * sizeof( DataType );
-                if( posAfterGather - posBeforeGather != sizeInBytes )
-                  DUNE_THROW( GridError, "Number of bytes read (" << (posAfterGather - posBeforeGather) << ") does not coincide with reported size (" << sizeInBytes << ")" );
+              const std::size_t posAfterGather = buffer.position();
+              const std::size_t sizeInBytes = static_cast< std::size_t >( size ) * sizeof( DataType );
+              if( posAfterGather - posBeforeGather != sizeInBytes )
+                DUNE_THROW( GridError, "Number of bytes read (" << (posAfterGather - posBeforeGather) << ") does not coincide with reported size (" << sizeInBytes << ")" );
 #endif // #ifndef NDEBUG
-              }
-            } );
-          break;
-        }
+            }
+          } );
+        break;
       }
     }
-    readBuffers_.clear();
+  }
 
-    for( typename std::vector< WriteBuffer >::iterator it = writeBuffers_.begin(); it != writeBuffers_.end(); ++it )
-      it->wait();
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunication< Grid, DataHandle >::finish ()
+  {
+    if( progress_ )
+      gridLevel_.grid().progressThread().release();
+    progress_ = false;
+
+    readBuffers_.clear();
     writeBuffers_.clear();
 
+    tag_.release();
     interface_ = nullptr;
   }
 
@@ -0,0 +1,266 @@
+#ifndef DUNE_SPGRID_COMMUNICATIONPLAN_HH
+#define DUNE_SPGRID_COMMUNICATIONPLAN_HH
+
+#include <cstddef>
+
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hybridutilities.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/iterator.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  reusable communication with persistent requests
+ */
+
+namespace Dune
+{
+
+  // SPCommunicationPlan
+  // -------------------
+
+  /**
+   * \class SPCommunicationPlan
+   * \brief communication of a data handle that is repeated many times with
+   *        the same shape
+   *
+   * A plan is set up once for a grid level, an interface, a direction and a
+   * data handle (type). The message sizes are computed in closed form from
+   * the number of entities in the send and receive lists, the buffers are
+   * allocated once and persistent requests are initialized. Each exchange
+   * then only gathers, starts the requests, waits and scatters:
+   * \code
+   * auto plan = gridView.impl().communicationPlan( dataHandle, iftype, dir );
+   * for( ;; )
+   * {
+   *   plan.start();
+   *   // compute something else
+   *   plan.wait();
+   * }
+   * \endcode
+   *
+   * \note The data handle must have fixed size for all codimensions it
+   *       contains and the sizes must not change during the lifetime of the
+   *       plan.
+   */
+  template< class Grid, class DataHandle >
+  class SPCommunicationPlan
+  {
+    typedef SPCommunicationPlan< Grid, DataHandle > This;
+
+  public:
+    static const int dimension = Grid::dimension;
+
+    typedef SPGridLevel< Grid > GridLevel;
+    typedef SPPartitionList< dimension > PartitionList;
+
+    typedef typename DataHandle::DataType DataType;
+
+    typedef typename GridLevel::CommInterface Interface;
+
+  private:
+    typedef SPPersistentMessageBuffer< typename Grid::Communication > Buffer;
+
+  public:
+    SPCommunicationPlan ( const GridLevel &gridLevel, DataHandle &dataHandle,
+                          InterfaceType iftype, CommunicationDirection dir );
+
+    SPCommunicationPlan ( const This & ) = delete;
+    SPCommunicationPlan ( This &&other );
+
+    ~SPCommunicationPlan () { wait(); }
+
+    This &operator= ( const This & ) = delete;
+
+    /** \brief gather the send data and start all requests */
+    void start ();
+
+    /** \brief wait for all requests and scatter the received data */
+    void wait ();
+
+    /** \brief perform one complete exchange */
+    void exchange () { start(); wait(); }
+
+    bool ready () const { return !active_; }
+
+  private:
+    std::size_t messageSize ( const PartitionList &partitionList ) const;
+
+    void gather ( const PartitionList &partitionList, Buffer &buffer );
+    void scatter ( const PartitionList &partitionList, Buffer &buffer );
+
+    const GridLevel &gridLevel_;
+    DataHandle &dataHandle_;
+    const Interface *interface_;
+    CommunicationDirection dir_;
+    bool active_;
+    SPCommTag tag_;
+    std::vector< Buffer > sendBuffers_;
+    std::vector< Buffer > receiveBuffers_;
+  };
+
+
+
+  // Implementation of SPCommunicationPlan
+  // -------------------------------------
+
+  template< class Grid, class DataHandle >
+  inline SPCommunicationPlan< Grid, DataHandle >
+    ::SPCommunicationPlan ( const GridLevel &gridLevel, DataHandle &dataHandle,
+                            InterfaceType iftype, CommunicationDirection dir )
+    : gridLevel_( gridLevel ),
+      dataHandle_( dataHandle ),
+      interface_( &gridLevel.commInterface( iftype ) ),
+      dir_( dir ),
+      active_( false )
+  {
+    for( int codim = 0; codim <= dimension; ++codim )
+    {
+      if( dataHandle_.contains( dimension, codim ) && !dataHandle_.fixedSize( dimension, codim ) )
+        DUNE_THROW( NotImplemented, "Communication plans require data handles of fixed size." );
+    }
+
+    // the persistent requests keep their tag for the lifetime of the plan
+    tag_ = SPCommTag( gridLevel.grid().tagAllocator(), SPTagAllocator::persistent );
+
+    const std::size_t numLinks = interface_->size();
+    sendBuffers_.reserve( numLinks );
+    receiveBuffers_.reserve( numLinks );
+    for( typename Interface::Iterator it = interface_->begin(); it != interface_->end(); ++it )
+    {
+      sendBuffers_.emplace_back( gridLevel.grid().messageComm(), messageSize( it->sendList( dir ) ) );
+      sendBuffers_.back().initSend( it->rank(), tag_ );
+
+      receiveBuffers_.emplace_back( gridLevel.grid().messageComm(), messageSize( it->receiveList( dir ) ) );
+      receiveBuffers_.back().initReceive( it->rank(), tag_ );
+    }
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline SPCommunicationPlan< Grid, DataHandle >::SPCommunicationPlan ( This &&other )
+    : gridLevel_( other.gridLevel_ ),
+      dataHandle_( other.dataHandle_ ),
+      interface_( other.interface_ ),
+      dir_( other.dir_ ),
+      active_( other.active_ ),
+      tag_( std::move( other.tag_ ) ),
+      sendBuffers_( std::move( other.sendBuffers_ ) ),
+      receiveBuffers_( std::move( other.receiveBuffers_ ) )
+  {
+    other.active_ = false;
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunicationPlan< Grid, DataHandle >::start ()
+  {
+    if( active_ )
+      DUNE_THROW( InvalidStateException, "Communication plan is already active." );
+    active_ = true;
+
+    for( Buffer &buffer : receiveBuffers_ )
+      buffer.start();
+
+    typename Interface::Iterator it = interface_->begin();
+    for( Buffer &buffer : sendBuffers_ )
+    {
+      buffer.rewind();
+      gather( (it++)->sendList( dir_ ), buffer );
+      buffer.start();
+    }
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunicationPlan< Grid, DataHandle >::wait ()
+  {
+    if( !active_ )
+      return;
+
+    for( std::size_t i = 0; i < receiveBuffers_.size(); ++i )
+    {
+      const typename std::vector< Buffer >::iterator buffer = waitAny( receiveBuffers_ );
+      const typename Interface::Iterator it = std::next( interface_->begin(), buffer - receiveBuffers_.begin() );
+      scatter( it->receiveList( dir_ ), *buffer );
+    }
+
+    for( Buffer &buffer : sendBuffers_ )
+      buffer.wait();
+
+    active_ = false;
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline std::size_t SPCommunicationPlan< Grid, DataHandle >::messageSize ( const PartitionList &partitionList ) const
+  {
+    std::size_t size = 0;
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, &size ] ( auto codim ) {
+        typedef SPPartitionIterator< codim, const Grid > Iterator;
+
+        if( !dataHandle_.contains( dimension, codim ) )
+          return;
+
+        // all entities of this codimension have the same size, so take the first one
+        const Iterator it( gridLevel_, partitionList, typename Iterator::Begin() );
+        const Iterator end( gridLevel_, partitionList, typename Iterator::End() );
+        if( it != end )
+          size += partitionList.volume( codim ) * dataHandle_.size( *it );
+      } );
+    return size * sizeof( DataType );
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunicationPlan< Grid, DataHandle >::gather ( const PartitionList &partitionList, Buffer &buffer )
+  {
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, &buffer ] ( auto codim ) {
+        typedef SPPartitionIterator< codim, const Grid > Iterator;
+
+        if( !dataHandle_.contains( dimension, codim ) )
+          return;
+
+        const Iterator end( gridLevel_, partitionList, typename Iterator::End() );
+        for( Iterator it( gridLevel_, partitionList, typename Iterator::Begin() ); it != end; ++it )
+          dataHandle_.gather( buffer, *it );
+      } );
+
+    if( buffer.position() != buffer.size() )
+      DUNE_THROW( GridError, "Number of bytes written (" << buffer.position() << ") does not coincide with planned message size (" << buffer.size() << ")" );
+  }
+
+
+  template< class Grid, class DataHandle >
+  inline void SPCommunicationPlan< Grid, DataHandle >::scatter ( const PartitionList &partitionList, Buffer &buffer )
+  {
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ this, &partitionList, &buffer ] ( auto codim ) {
+        typedef SPPartitionIterator< codim, const Grid > Iterator;
+
+        if( !dataHandle_.contains( dimension, codim ) )
+          return;
+
+        const Iterator end( gridLevel_, partitionList, typename Iterator::End() );
+        for( Iterator it( gridLevel_, partitionList, typename Iterator::Begin() ); it != end; ++it )
+        {
+          const auto &entity = *it;
+          dataHandle_.scatter( buffer, entity, dataHandle_.size( entity ) );
+        }
+      } );
+
+    if( buffer.position() != buffer.size() )
+      DUNE_THROW( GridError, "Number of bytes read (" << buffer.position() << ") does not coincide with planned message size (" << buffer.size() << ")" );
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_COMMUNICATIONPLAN_HH
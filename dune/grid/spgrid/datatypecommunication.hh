@@ -0,0 +1,316 @@
+#ifndef DUNE_SPGRID_DATATYPECOMMUNICATION_HH
+#define DUNE_SPGRID_DATATYPECOMMUNICATION_HH
+
+#include <cassert>
+#include <cstddef>
+
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+#include <dune/common/parallel/mpitraits.hh>
+
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/direction.hh>
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/vectorcommunication.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  zero-copy communication of vectors indexed by an SPIndexSet
+ */
+
+namespace Dune
+{
+
+  // SPDatatypeCommunication
+  // -----------------------
+
+  /**
+   * \class SPDatatypeCommunication
+   * \brief communication of a vector indexed by an SPIndexSet using derived
+   *        datatypes
+   *
+   * The send and receive regions of each link consist of boxes in the index
+   * layout of the index set. Each box is described by a subarray datatype;
+   * the boxes of one link are combined into a single struct datatype.
+   * MPI thus reads from and writes to the user's vector directly, without
+   * gathering and scattering the data into message buffers.
+   *
+   * If the region received on a link overlaps a region sent on any link or
+   * received on another link (e.g., border entities in the
+   * InteriorBorder_InteriorBorder interface), receiving directly into the
+   * vector would race with the pending sends. Such links are received as
+   * MPI_PACKED into a staging buffer and unpacked with the receive datatype
+   * in wait, in the order of the links.
+   *
+   * The datatypes are set up once on construction and may be used for many
+   * exchanges:
+   * \code
+   * SPDatatypeCommunication< Grid, double > communication( gridView.indexSet(), codim, iftype, dir );
+   * communication.start( data );
+   * // compute something else
+   * communication.wait();
+   * \endcode
+   *
+   * \note The index set must use the lexicographic ordering without
+   *       owned-first numbering. The vector must hold blockSize values for
+   *       each entity of the given codimension and must not be reallocated
+   *       while a communication is in progress.
+   */
+  template< class Grid, class T, class Comm = typename Grid::Communication >
+  class SPDatatypeCommunication
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPDatatypeCommunication< Grid, T, Comm > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+
+    SPDatatypeCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 )
+      : Base( indexSet, codim, iftype, dir, blockSize )
+    {
+      if( indexSet.isOwnedFirst() )
+        DUNE_THROW( NotImplemented, "Datatype communication requires the lexicographic index layout." );
+      assert( this->interface_.size() == 0u );
+    }
+
+    void start ( std::vector< T > &data ) { this->checkSize( data ); }
+    void wait () {}
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return true; }
+  };
+
+#if HAVE_MPI
+  template< class Grid, class T >
+  class SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+    typedef typename Base::Interface Interface;
+    typedef typename Base::PartitionList PartitionList;
+
+    using Base::dimension;
+
+    SPDatatypeCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 );
+
+    SPDatatypeCommunication ( const This & ) = delete;
+
+    ~SPDatatypeCommunication ();
+
+    This &operator= ( const This & ) = delete;
+
+    void start ( std::vector< T > &data );
+    void wait ();
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return requests_.empty(); }
+
+  private:
+    MPI_Datatype createDatatype ( const PartitionList &partitionList ) const;
+
+    std::vector< bool > overlappingReceives () const;
+
+    MPI_Comm comm_;
+    SPCommTag tag_;
+    MPI_Datatype blockType_;
+    std::vector< MPI_Datatype > sendTypes_, receiveTypes_;
+    std::vector< std::vector< char > > staging_;
+    std::vector< MPI_Request > requests_;
+    T *data_ = nullptr;
+  };
+#endif // #if HAVE_MPI
+
+
+
+#if HAVE_MPI
+  // Implementation of SPDatatypeCommunication
+  // -----------------------------------------
+
+  template< class Grid, class T >
+  inline SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >
+    ::SPDatatypeCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize )
+    : Base( indexSet, codim, iftype, dir, blockSize ),
+      comm_( indexSet.gridLevel().grid().messageComm() )
+  {
+    if( indexSet.isOwnedFirst() )
+      DUNE_THROW( NotImplemented, "Datatype communication requires the lexicographic index layout." );
+
+    MPI_Type_contiguous( blockSize, MPITraits< T >::getType(), &blockType_ );
+    MPI_Type_commit( &blockType_ );
+
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      sendTypes_.push_back( createDatatype( it->sendList( dir ) ) );
+      receiveTypes_.push_back( createDatatype( it->receiveList( dir ) ) );
+    }
+
+    // links whose receive region overlaps another region are received into a staging buffer
+    const std::vector< bool > overlapping = overlappingReceives();
+    for( std::size_t i = 0; i < receiveTypes_.size(); ++i )
+    {
+      int size = 0;
+      if( overlapping[ i ] )
+        MPI_Pack_size( 1, receiveTypes_[ i ], comm_, &size );
+      staging_.emplace_back( size );
+    }
+  }
+
+
+  template< class Grid, class T >
+  inline SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >::~SPDatatypeCommunication ()
+  {
+    wait();
+    for( MPI_Datatype &type : sendTypes_ )
+      MPI_Type_free( &type );
+    for( MPI_Datatype &type : receiveTypes_ )
+      MPI_Type_free( &type );
+    MPI_Type_free( &blockType_ );
+  }
+
+
+  template< class Grid, class T >
+  inline void SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >::start ( std::vector< T > &data )
+  {
+    if( !ready() )
+      DUNE_THROW( InvalidStateException, "Datatype communication is already in progress." );
+    this->checkSize( data );
+
+    tag_ = SPCommTag( this->indexSet().gridLevel().grid().tagAllocator() );
+    const std::size_t numLinks = this->interface_.size();
+    requests_.resize( 2*numLinks );
+
+    typename Interface::Iterator it = this->interface_.begin();
+    for( std::size_t i = 0; i < numLinks; ++i, ++it )
+    {
+      if( staging_[ i ].empty() )
+        MPI_Irecv( data.data(), 1, receiveTypes_[ i ], it->rank(), tag_, comm_, &requests_[ i ] );
+      else
+        MPI_Irecv( staging_[ i ].data(), staging_[ i ].size(), MPI_PACKED, it->rank(), tag_, comm_, &requests_[ i ] );
+    }
+
+    it = this->interface_.begin();
+    for( std::size_t i = 0; i < numLinks; ++i, ++it )
+      MPI_Isend( data.data(), 1, sendTypes_[ i ], it->rank(), tag_, comm_, &requests_[ numLinks + i ] );
+    data_ = data.data();
+  }
+
+
+  template< class Grid, class T >
+  inline void SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >::wait ()
+  {
+    if( ready() )
+      return;
+
+    MPI_Waitall( requests_.size(), requests_.data(), MPI_STATUSES_IGNORE );
+    requests_.clear();
+
+    // all sends are complete, so the staged data may now be written
+    for( std::size_t i = 0; i < staging_.size(); ++i )
+    {
+      int position = 0;
+      if( !staging_[ i ].empty() )
+        MPI_Unpack( staging_[ i ].data(), staging_[ i ].size(), &position, data_, 1, receiveTypes_[ i ], comm_ );
+    }
+
+    data_ = nullptr;
+    tag_.release();
+  }
+
+
+  template< class Grid, class T >
+  inline std::vector< bool > SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >::overlappingReceives () const
+  {
+    const std::size_t size = this->indexSet().size( this->codimension() );
+    auto forEachIndex = [ this ] ( const PartitionList &partitionList, auto &&f ) {
+        __SPGrid::forEachLine( this->indexSet(), partitionList, this->codimension(), [ &f ] ( const auto &line ) {
+            for( std::size_t i = 0; i < std::size_t( line.size() ); ++i )
+              f( std::size_t( line.index() ) + i * std::size_t( line.stride() ) );
+          } );
+      };
+
+    // mark the entities sent on any link and count the links receiving each entity
+    std::vector< bool > sent( size, false );
+    std::vector< int > received( size, 0 );
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      forEachIndex( it->sendList( this->dir_ ), [ &sent ] ( std::size_t index ) { sent[ index ] = true; } );
+      forEachIndex( it->receiveList( this->dir_ ), [ &received ] ( std::size_t index ) { ++received[ index ]; } );
+    }
+
+    std::vector< bool > overlapping;
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      bool overlaps = false;
+      forEachIndex( it->receiveList( this->dir_ ), [ &sent, &received, &overlaps ] ( std::size_t index ) {
+          overlaps |= (sent[ index ] || (received[ index ] > 1));
+        } );
+      overlapping.push_back( overlaps );
+    }
+    return overlapping;
+  }
+
+
+  template< class Grid, class T >
+  inline MPI_Datatype SPDatatypeCommunication< Grid, T, Communication< MPI_Comm > >
+    ::createDatatype ( const PartitionList &partitionList ) const
+  {
+    typedef typename IndexSet::Layout Layout;
+    typedef SPDirection< dimension > Direction;
+
+    MPI_Aint lowerBound, extent;
+    MPI_Type_get_extent( blockType_, &lowerBound, &extent );
+
+    // one subarray per partition and direction, in the order of the partition iterator
+    std::vector< MPI_Datatype > types;
+    std::vector< MPI_Aint > displacements;
+    for( typename PartitionList::Iterator pit = partitionList.begin(); pit; ++pit )
+    {
+      for( unsigned long dir = 0; dir < (1ul << dimension); ++dir )
+      {
+        if( (Direction( dir ).codimension() != this->codimension()) || pit->empty( Direction( dir ) ) )
+          continue;
+
+        const Layout &layout = this->indexSet().layout( pit->number(), dir );
+        int sizes[ dimension ], subSizes[ dimension ], starts[ dimension ];
+        for( int i = 0; i < dimension; ++i )
+        {
+          const unsigned int d = (dir >> i) & 1;
+          sizes[ i ] = (layout.end()[ i ] - layout.begin()[ i ]) / 2 + 1;
+          subSizes[ i ] = (pit->bound( 1, i, d ) - pit->bound( 0, i, d )) / 2 + 1;
+          starts[ i ] = (pit->bound( 0, i, d ) - layout.begin()[ i ]) / 2;
+          assert( (starts[ i ] >= 0) && (starts[ i ] + subSizes[ i ] <= sizes[ i ]) );
+        }
+
+        MPI_Datatype type;
+        MPI_Type_create_subarray( dimension, sizes, subSizes, starts, MPI_ORDER_FORTRAN, blockType_, &type );
+        types.push_back( type );
+        displacements.push_back( MPI_Aint( layout.offset() ) * extent );
+      }
+    }
+
+    const std::vector< int > blockLengths( types.size(), 1 );
+    MPI_Datatype type;
+    MPI_Type_create_struct( types.size(), blockLengths.data(), displacements.data(), types.data(), &type );
+    MPI_Type_commit( &type );
+
+    for( MPI_Datatype &t : types )
+      MPI_Type_free( &t );
+    return type;
+  }
+#endif // #if HAVE_MPI
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_DATATYPECOMMUNICATION_HH
@@ -16,7 +16,7 @@ namespace Dune
   template< int >
   class SPBisectionRefinement;
 
-  template< class, int, template< int > class, class >
+  template< class, int, template< int > class, class, class >
   class SPGrid;
 
 } // namespace Dune
@@ -74,11 +74,11 @@ namespace Dune
   // DGFGridFactory< SPGrid >
   // ------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  class DGFGridFactory< SPGrid< ct, dim, Ref, Comm > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  class DGFGridFactory< SPGrid< ct, dim, Ref, Comm, Index > >
   {
   public:
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
     typedef MPIHelper::MPICommunicator MPICommunicatorType;
     typedef typename Grid::Communication Communication;
@@ -182,16 +182,16 @@ namespace Dune
   // Implementation of DGFGridFactory< SPGrid >
   // ------------------------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline DGFGridFactory< SPGrid< ct, dim, Ref, Comm > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline DGFGridFactory< SPGrid< ct, dim, Ref, Comm, Index > >
     ::DGFGridFactory ( std::istream &input, MPICommunicatorType comm )
   {
     generate( input, SPCommunicationTraits< Comm >::comm( comm ) );
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline DGFGridFactory< SPGrid< ct, dim, Ref, Comm > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline DGFGridFactory< SPGrid< ct, dim, Ref, Comm, Index > >
     ::DGFGridFactory ( const std::string &filename, MPICommunicatorType comm )
   {
     std::ifstream input( filename.c_str() );
@@ -202,9 +202,9 @@ namespace Dune
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
   inline void
-  DGFGridFactory< SPGrid< ct, dim, Ref, Comm > >
+  DGFGridFactory< SPGrid< ct, dim, Ref, Comm, Index > >
     ::generate ( std::istream &input, const Communication &comm )
   {
     dgf::IntervalBlock intervalBlock( input );
@@ -280,10 +280,10 @@ namespace Dune
   // DGFGridInfo< SPGrid >
   // ---------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  struct DGFGridInfo< SPGrid< ct, dim, Ref, Comm > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  struct DGFGridInfo< SPGrid< ct, dim, Ref, Comm, Index > >
   {
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
     typedef typename Grid::RefinementPolicy RefinementPolicy;
 
     static int refineStepsForHalf ( const RefinementPolicy &policy = RefinementPolicy() )
@@ -0,0 +1,196 @@
+#ifndef DUNE_SPGRID_FOREACH_HH
+#define DUNE_SPGRID_FOREACH_HH
+
+#include <array>
+#include <type_traits>
+
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/gridview.hh>
+
+#include <dune/grid/spgrid/lineiterator.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  entity-free traversal of a grid view
+ */
+
+namespace Dune
+{
+
+  // forEachEntity
+  // -------------
+
+  /**
+   * \brief call a function for each entity of a grid view without
+   *        constructing entities
+   *
+   * The function is called either as <tt>f( id, index )</tt> or as
+   * <tt>f( id, index, center )</tt>, where id is the multi index of the
+   * entity, index is its index in the grid view's index set and center is the
+   * global coordinate of its center. The center is only computed if f accepts
+   * it; along a line of entities, only its first coordinate is updated.
+   *
+   * For the lexicographic ordering, the entities are visited in the order of
+   * the default traversal, using the line iterator. Otherwise, the entities
+   * are visited in the order of the grid view's iterator.
+   *
+   * \tparam  codim   codimension of the entities to traverse
+   * \tparam  pitype  partition to traverse
+   */
+  template< int codim, PartitionIteratorType pitype = All_Partition, class VT, class F >
+  inline void forEachEntity ( const GridView< VT > &gridView, F &&f )
+  {
+    typedef typename GridView< VT >::Implementation Implementation;
+    typedef typename Implementation::GridLevel GridLevel;
+    typedef typename Implementation::IndexSet::IndexType IndexType;
+    typedef typename GridLevel::MultiIndex MultiIndex;
+    typedef typename GridLevel::GlobalVector GlobalVector;
+
+    static const int dimension = GridLevel::dimension;
+    static const bool withCenter = std::is_invocable< F &, const MultiIndex &, IndexType, const GlobalVector & >::value;
+
+    const Implementation &view = gridView.impl();
+    const GridLevel &gridLevel = view.gridLevel();
+
+    // center = origin + id * h/2
+    GlobalVector halfH = gridLevel.h();
+    halfH *= 0.5;
+    const GlobalVector origin = gridLevel.domain().cube().origin();
+    auto center = [ &origin, &halfH ] ( const MultiIndex &id ) {
+        GlobalVector x = origin;
+        for( int i = 0; i < dimension; ++i )
+          x[ i ] += id[ i ] * halfH[ i ];
+        return x;
+      };
+
+    if( view.indexSet().partitionOrdering() )
+    {
+      const auto end = view.template end< codim, pitype >();
+      for( auto it = view.template begin< codim, pitype >(); it != end; ++it )
+      {
+        const MultiIndex &id = it.impl().entityInfo().id();
+        const IndexType index = view.indexSet().index( *it );
+        if constexpr( withCenter )
+          f( id, index, center( id ) );
+        else
+          f( id, index );
+      }
+      return;
+    }
+
+    const auto lend = view.template lineEnd< codim, pitype >();
+    for( auto lit = view.template lineBegin< codim, pitype >(); lit != lend; ++lit )
+    {
+      MultiIndex id = lit->id();
+      IndexType index = lit->index();
+      if constexpr( withCenter )
+      {
+        // only the first coordinate changes along the line (recomputing it avoids round-off accumulation)
+        GlobalVector x = center( id );
+        for( IndexType k = 0; k < lit->size(); ++k, id[ 0 ] += 2, index += lit->stride() )
+        {
+          x[ 0 ] = origin[ 0 ] + id[ 0 ] * halfH[ 0 ];
+          f( static_cast< const MultiIndex & >( id ), index, static_cast< const GlobalVector & >( x ) );
+        }
+      }
+      else
+      {
+        for( IndexType k = 0; k < lit->size(); ++k, id[ 0 ] += 2, index += lit->stride() )
+          f( static_cast< const MultiIndex & >( id ), index );
+      }
+    }
+  }
+
+
+
+  // fillCenters
+  // -----------
+
+  /**
+   * \brief compute the centers of all entities of a grid view in structure of
+   *        arrays layout
+   *
+   * For each entity of the given codimension and partition, the i-th
+   * coordinate of its center is stored in <tt>x[ i ][ index ]</tt>, where
+   * index is the entity's index in the grid view's index set. The coordinates
+   * are computed directly from the domain origin and h. Along a line of
+   * entities, only the first coordinate varies, so that the loops vectorize.
+   * Vertex coordinates are obtained for codim = dimension.
+   *
+   * \note The arrays must hold at least <tt>gridView.size( codim )</tt>
+   *       values; entries of entities outside the partition are not touched.
+   *
+   * \tparam  codim   codimension of the entities
+   * \tparam  pitype  partition to traverse
+   */
+  template< int codim, PartitionIteratorType pitype = All_Partition, class VT >
+  inline void fillCenters ( const GridView< VT > &gridView, const std::array< typename GridView< VT >::ctype *, GridView< VT >::dimension > &x )
+  {
+    typedef typename GridView< VT >::Implementation Implementation;
+    typedef typename Implementation::GridLevel GridLevel;
+    typedef typename Implementation::IndexSet::IndexType IndexType;
+    typedef typename GridLevel::MultiIndex MultiIndex;
+    typedef typename GridLevel::GlobalVector GlobalVector;
+    typedef typename GridView< VT >::ctype ctype;
+
+    static const int dimension = GridLevel::dimension;
+
+    const Implementation &view = gridView.impl();
+    if( view.indexSet().partitionOrdering() )
+    {
+      forEachEntity< codim, pitype >( gridView, [ &x ] ( const MultiIndex &id, IndexType index, const GlobalVector &center ) {
+          for( int i = 0; i < dimension; ++i )
+            x[ i ][ index ] = center[ i ];
+        } );
+      return;
+    }
+
+    const GridLevel &gridLevel = view.gridLevel();
+    GlobalVector halfH = gridLevel.h();
+    halfH *= 0.5;
+    const GlobalVector origin = gridLevel.domain().cube().origin();
+
+    const auto lend = view.template lineEnd< codim, pitype >();
+    for( auto lit = view.template lineBegin< codim, pitype >(); lit != lend; ++lit )
+    {
+      const MultiIndex &id = lit->id();
+      const IndexType size = lit->size();
+      const IndexType stride = lit->stride();
+
+      // first coordinate: x_0 = origin_0 + (id_0 + 2k) * h_0/2
+      ctype *const x0 = x[ 0 ] + lit->index();
+      const ctype o = origin[ 0 ] + id[ 0 ] * halfH[ 0 ];
+      const ctype h = 2 * halfH[ 0 ];
+      if( stride == 1 )
+      {
+        for( IndexType k = 0; k < size; ++k )
+          x0[ k ] = o + ctype( k ) * h;
+      }
+      else
+      {
+        for( IndexType k = 0; k < size; ++k )
+          x0[ k*stride ] = o + ctype( k ) * h;
+      }
+
+      // remaining coordinates are constant along the line
+      for( int i = 1; i < dimension; ++i )
+      {
+        ctype *const xi = x[ i ] + lit->index();
+        const ctype c = origin[ i ] + id[ i ] * halfH[ i ];
+        if( stride == 1 )
+        {
+          for( IndexType k = 0; k < size; ++k )
+            xi[ k ] = c;
+        }
+        else
+        {
+          for( IndexType k = 0; k < size; ++k )
+            xi[ k*stride ] = c;
+        }
+      }
+    }
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_FOREACH_HH
@@ -0,0 +1,304 @@
+#ifndef DUNE_SPGRID_FUSEDCOMMUNICATION_HH
+#define DUNE_SPGRID_FUSEDCOMMUNICATION_HH
+
+#include <cassert>
+#include <cstddef>
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
+#include <dune/grid/spgrid/vectorcommunication.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  communication of several vectors in one message per link
+ */
+
+namespace Dune
+{
+
+  // SPFusedCommunication
+  // --------------------
+
+  /**
+   * \class SPFusedCommunication
+   * \brief communication of several vectors indexed by an SPIndexSet in one
+   *        message per link
+   *
+   * Vectors of arbitrary (trivially copyable) value type, codimension and
+   * block size are registered once. Each exchange then traverses the lines
+   * of every send and receive list once per codimension, copying the data
+   * of all registered vectors for that line, and sends one aggregated
+   * message per link with a single tag:
+   * \code
+   * SPFusedCommunication< Grid > communication( gridView.indexSet(), iftype, dir );
+   * communication.add( pressure, 0 );
+   * communication.add( velocity, dim, dim );
+   * communication.exchange();
+   * \endcode
+   *
+   * \note The index set must not use a space-filling curve ordering. The
+   *       registered vectors must not be reallocated while a communication
+   *       is in progress.
+   */
+  template< class Grid >
+  class SPFusedCommunication
+  {
+    typedef SPFusedCommunication< Grid > This;
+
+  public:
+    static const int dimension = Grid::dimension;
+
+    typedef SPIndexSet< const Grid > IndexSet;
+    typedef typename IndexSet::GridLevel GridLevel;
+    typedef typename GridLevel::CommInterface Interface;
+    typedef typename GridLevel::PartitionList PartitionList;
+
+  private:
+    typedef SPPackedMessageWriteBuffer< typename Grid::Communication > WriteBuffer;
+    typedef SPPackedMessageReadBuffer< typename Grid::Communication > ReadBuffer;
+
+    struct Field
+    {
+      virtual ~Field () = default;
+
+      virtual int codimension () const = 0;
+      virtual std::size_t entitySize () const = 0;
+      virtual std::size_t entities () const = 0;
+
+      virtual void pack ( std::size_t index, std::size_t size, std::size_t stride, WriteBuffer &buffer ) const = 0;
+      virtual void unpack ( std::size_t index, std::size_t size, std::size_t stride, ReadBuffer &buffer ) = 0;
+    };
+
+    template< class T >
+    struct VectorField;
+
+  public:
+    SPFusedCommunication ( const IndexSet &indexSet, InterfaceType iftype, CommunicationDirection dir );
+
+    SPFusedCommunication ( const This & ) = delete;
+
+    ~SPFusedCommunication () { wait(); }
+
+    This &operator= ( const This & ) = delete;
+
+    /** \brief register a vector holding blockSize values per entity of given codimension */
+    template< class T >
+    void add ( std::vector< T > &data, int codim, int blockSize = 1 );
+
+    /** \brief number of registered vectors */
+    std::size_t size () const { return fields_.size(); }
+
+    void start ();
+    void wait ();
+
+    void exchange () { start(); wait(); }
+
+    bool ready () const { return !active_; }
+
+  private:
+    template< class F >
+    void forEachLine ( const PartitionList &partitionList, F &&f ) const;
+
+    std::size_t messageSize ( const PartitionList &partitionList ) const;
+
+    void pack ( const PartitionList &partitionList, WriteBuffer &buffer ) const;
+    void unpack ( const PartitionList &partitionList, ReadBuffer &buffer );
+
+    const IndexSet &indexSet_;
+    const Interface &interface_;
+    CommunicationDirection dir_;
+    bool active_;
+    std::vector< std::unique_ptr< Field > > fields_;
+    SPCommTag tag_;
+    std::vector< WriteBuffer > writeBuffers_;
+    std::vector< ReadBuffer > readBuffers_;
+  };
+
+
+
+  // SPFusedCommunication::VectorField
+  // ---------------------------------
+
+  template< class Grid >
+  template< class T >
+  struct SPFusedCommunication< Grid >::VectorField
+    : public Field
+  {
+    static_assert( std::is_trivially_copyable< T >::value, "SPFusedCommunication requires trivially copyable values." );
+
+    VectorField ( std::vector< T > &data, int codim, int blockSize )
+      : data_( data ), codim_( codim ), blockSize_( blockSize )
+    {}
+
+    int codimension () const override { return codim_; }
+    std::size_t entitySize () const override { return blockSize_ * sizeof( T ); }
+    std::size_t entities () const override { return data_.size() / blockSize_; }
+
+    void pack ( std::size_t index, std::size_t size, std::size_t stride, WriteBuffer &buffer ) const override
+    {
+      __SPGrid::packLine( data_.data() + index * blockSize_, size, stride, blockSize_, buffer );
+    }
+
+    void unpack ( std::size_t index, std::size_t size, std::size_t stride, ReadBuffer &buffer ) override
+    {
+      __SPGrid::unpackLine( data_.data() + index * blockSize_, size, stride, blockSize_, buffer );
+    }
+
+  private:
+    std::vector< T > &data_;
+    int codim_;
+    std::size_t blockSize_;
+  };
+
+
+
+  // Implementation of SPFusedCommunication
+  // --------------------------------------
+
+  template< class Grid >
+  inline SPFusedCommunication< Grid >
+    ::SPFusedCommunication ( const IndexSet &indexSet, InterfaceType iftype, CommunicationDirection dir )
+    : indexSet_( indexSet ),
+      interface_( indexSet.gridLevel().commInterface( iftype ) ),
+      dir_( dir ),
+      active_( false )
+  {
+    if( indexSet.partitionOrdering() )
+      DUNE_THROW( NotImplemented, "Fused communication requires lexicographic ordering (got " << indexSet.ordering().name() << ")." );
+  }
+
+
+  template< class Grid >
+  template< class T >
+  inline void SPFusedCommunication< Grid >::add ( std::vector< T > &data, int codim, int blockSize )
+  {
+    assert( (codim >= 0) && (codim <= dimension) && (blockSize > 0) );
+    if( active_ )
+      DUNE_THROW( InvalidStateException, "Cannot add vectors to a fused communication in progress." );
+    if( data.size() < std::size_t( indexSet_.size( codim ) ) * std::size_t( blockSize ) )
+      DUNE_THROW( RangeError, "Vector too small for communication (size: " << data.size() << ")." );
+    fields_.emplace_back( new VectorField< T >( data, codim, blockSize ) );
+  }
+
+
+  template< class Grid >
+  inline void SPFusedCommunication< Grid >::start ()
+  {
+    if( active_ )
+      DUNE_THROW( InvalidStateException, "Fused communication is already in progress." );
+    for( const std::unique_ptr< Field > &field : fields_ )
+    {
+      if( field->entities() < std::size_t( indexSet_.size( field->codimension() ) ) )
+        DUNE_THROW( RangeError, "Registered vector too small for communication (entities: " << field->entities() << ")." );
+    }
+    active_ = true;
+
+    const auto &comm = indexSet_.gridLevel().grid().messageComm();
+    SPMessageBufferPool &pool = indexSet_.gridLevel().bufferPool();
+    tag_ = SPCommTag( indexSet_.gridLevel().grid().tagAllocator() );
+
+    readBuffers_.reserve( interface_.size() );
+    for( typename Interface::Iterator it = interface_.begin(); it != interface_.end(); ++it )
+    {
+      readBuffers_.emplace_back( comm, pool );
+      readBuffers_.back().receive( it->rank(), tag_, messageSize( it->receiveList( dir_ ) ) );
+    }
+
+    writeBuffers_.reserve( interface_.size() );
+    for( typename Interface::Iterator it = interface_.begin(); it != interface_.end(); ++it )
+    {
+      writeBuffers_.emplace_back( comm, pool, it->rank() );
+      pack( it->sendList( dir_ ), writeBuffers_.back() );
+      writeBuffers_.back().send( it->rank(), tag_ );
+    }
+  }
+
+
+  template< class Grid >
+  inline void SPFusedCommunication< Grid >::wait ()
+  {
+    if( !active_ )
+      return;
+
+    for( std::size_t i = 0; i < interface_.size(); ++i )
+    {
+      const typename std::vector< ReadBuffer >::iterator buffer = waitAny( readBuffers_ );
+      const typename Interface::Iterator it = std::next( interface_.begin(), buffer - readBuffers_.begin() );
+      unpack( it->receiveList( dir_ ), *buffer );
+    }
+    readBuffers_.clear();
+
+    for( WriteBuffer &buffer : writeBuffers_ )
+      buffer.wait();
+    writeBuffers_.clear();
+
+    tag_.release();
+    active_ = false;
+  }
+
+
+  template< class Grid >
+  template< class F >
+  inline void SPFusedCommunication< Grid >::forEachLine ( const PartitionList &partitionList, F &&f ) const
+  {
+    // traverse each codimension once, no matter how many vectors it carries
+    for( int codim = 0; codim <= dimension; ++codim )
+    {
+      std::vector< Field * > fields;
+      for( const std::unique_ptr< Field > &field : fields_ )
+      {
+        if( field->codimension() == codim )
+          fields.push_back( field.get() );
+      }
+      if( fields.empty() )
+        continue;
+
+      __SPGrid::forEachLine( indexSet_, partitionList, codim, [ &fields, &f ] ( const auto &line ) {
+          for( Field *field : fields )
+            f( *field, std::size_t( line.index() ), std::size_t( line.size() ), std::size_t( line.stride() ) );
+        } );
+    }
+  }
+
+
+  template< class Grid >
+  inline std::size_t SPFusedCommunication< Grid >::messageSize ( const PartitionList &partitionList ) const
+  {
+    std::size_t size = 0;
+    for( const std::unique_ptr< Field > &field : fields_ )
+      size += partitionList.volume( field->codimension() ) * field->entitySize();
+    return size;
+  }
+
+
+  template< class Grid >
+  inline void SPFusedCommunication< Grid >::pack ( const PartitionList &partitionList, WriteBuffer &buffer ) const
+  {
+    forEachLine( partitionList, [ &buffer ] ( const Field &field, std::size_t index, std::size_t size, std::size_t stride ) {
+        field.pack( index, size, stride, buffer );
+      } );
+  }
+
+
+  template< class Grid >
+  inline void SPFusedCommunication< Grid >::unpack ( const PartitionList &partitionList, ReadBuffer &buffer )
+  {
+    forEachLine( partitionList, [ &buffer ] ( Field &field, std::size_t index, std::size_t size, std::size_t stride ) {
+        field.unpack( index, size, stride, buffer );
+      } );
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_FUSEDCOMMUNICATION_HH
@@ -3,6 +3,7 @@
 
 #include <cstddef>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <utility>
@@ -22,6 +23,7 @@
 #include <dune/grid/spgrid/indexset.hh>
 #include <dune/grid/spgrid/hindexset.hh>
 #include <dune/grid/spgrid/fileio.hh>
+#include <dune/grid/spgrid/refinementobserver.hh>
 
 namespace Dune
 {
@@ -46,10 +48,10 @@ namespace Dune
   // -----------------------------
 
 #if HAVE_MPI
-  template< class ct, int dim, template< int > class Ref = SPIsotropicRefinement, class Comm = MPI_Comm >
+  template< class ct, int dim, template< int > class Ref = SPIsotropicRefinement, class Comm = MPI_Comm, class Index = unsigned int >
   class SPGrid;
 #else
-  template< class ct, int dim, template< int > class Ref = SPIsotropicRefinement, class Comm = No_Comm >
+  template< class ct, int dim, template< int > class Ref = SPIsotropicRefinement, class Comm = No_Comm, class Index = unsigned int >
   class SPGrid;
 #endif // #if !HAVE_MPI
 
@@ -58,17 +60,18 @@ namespace Dune
   // SPGridFamily
   // ------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
   struct SPGridFamily
   {
     struct Traits
     {
-      typedef SPGrid< ct, dim, Ref, Comm > Grid;
+      typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
       typedef SPReferenceCubeContainer< ct, dim > ReferenceCubeContainer;
       typedef typename ReferenceCubeContainer::ReferenceCube ReferenceCube;
       typedef SPDomain< ct, dim > Domain;
       typedef SPMesh< dim > Mesh;
+      typedef Index IndexType;
       typedef Ref< dim > Refinement;
       typedef typename Refinement::Policy RefinementPolicy;
 
@@ -130,13 +133,15 @@ namespace Dune
    *  \tparam  dim       dimension of the grid
    *  \tparam  Ref       refinement (default is SPIsotropicRefinement)
    *  \tparam  Comm      type of communicator (default depends on HAVE_MPI)
+   *  \tparam  Index     type of entity indices (default is unsigned int);
+   *                     use a 64-bit type for grids with more than 2^32 entities
    */
-  template< class ct, int dim, template< int > class Ref, class Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
   class SPGrid
-    : public GridDefaultImplementation< dim, dim, ct, SPGridFamily< ct, dim, Ref, Comm > >
+    : public GridDefaultImplementation< dim, dim, ct, SPGridFamily< ct, dim, Ref, Comm, Index > >
   {
-    typedef SPGrid< ct, dim, Ref, Comm > This;
-    typedef GridDefaultImplementation< dim, dim, ct, SPGridFamily< ct, dim, Ref, Comm > > Base;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > This;
+    typedef GridDefaultImplementation< dim, dim, ct, SPGridFamily< ct, dim, Ref, Comm, Index > > Base;
 
     friend struct BackupRestoreFacility< This >;
     friend class SPIntersection< const This >;
@@ -145,7 +150,7 @@ namespace Dune
     template< class, class > friend class __SPGrid::TreeIterator;
 
   public:
-    typedef SPGridFamily< ct, dim, Ref, Comm > GridFamily;
+    typedef SPGridFamily< ct, dim, Ref, Comm, Index > GridFamily;
 
     typedef typename GridFamily::Traits Traits;
 
@@ -153,6 +158,7 @@ namespace Dune
     typedef typename Traits::ReferenceCube ReferenceCube;
     typedef typename Traits::Domain Domain;
     typedef typename Traits::Mesh Mesh;
+    typedef typename Traits::IndexType IndexType;
     typedef typename Traits::Refinement Refinement;
     typedef typename Traits::RefinementPolicy RefinementPolicy;
 
@@ -188,6 +194,8 @@ namespace Dune
 
     typedef SPGridLevel< This > GridLevel;
 
+    typedef SPRefinementObserver< This > RefinementObserver;
+
     typedef typename GridLevel::MultiIndex MultiIndex;
     static const int numDirections = GridLevel::numDirections;
 
@@ -214,6 +222,8 @@ namespace Dune
     SPGrid ( const This & ) = delete;
     SPGrid ( This &&other );
 
+    ~SPGrid ();
+
     const ReferenceCube &referenceCube () const
     {
       return refCubes_.get();
@@ -234,24 +244,24 @@ namespace Dune
       return leafLevel().level();
     }
 
-    int size ( const int level, const int codim ) const
+    IndexType size ( const int level, const int codim ) const
     {
-      return levelGridView( level ).size( codim );
+      return levelGridView( level ).impl().size( codim );
     }
 
-    int size ( const int codim ) const
+    IndexType size ( const int codim ) const
     {
-      return leafGridView().size( codim );
+      return leafGridView().impl().size( codim );
     }
 
-    int size ( const int level, const GeometryType &type ) const
+    IndexType size ( const int level, const GeometryType &type ) const
     {
-      return levelGridView( level ).size( type );
+      return levelGridView( level ).impl().size( type );
     }
 
-    int size ( const GeometryType &type ) const
+    IndexType size ( const GeometryType &type ) const
     {
-      return leafGridView().size( type );
+      return leafGridView().impl().size( type );
     }
 
     LevelGridView levelGridView ( int level ) const
@@ -294,6 +304,22 @@ namespace Dune
       return view.impl().template end< codim >( sweepDir );
     }
 
+    template< int codim, PartitionIteratorType pitype >
+    typename Traits::template Codim< codim >::template Partition< pitype >::LevelIterator
+    lbegin ( const int level, const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const
+    {
+      const LevelGridView &view = levelGridView( level );
+      return view.impl().template begin< codim, pitype >( tileSize, sweepDir );
+    }
+
+    template< int codim >
+    typename Traits::template Codim< codim >::LevelIterator
+    lbegin ( const int level, const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const
+    {
+      const LevelGridView &view = levelGridView( level );
+      return view.impl().template begin< codim >( tileSize, sweepDir );
+    }
+
     template< int codim, PartitionIteratorType pitype >
     typename Traits::template Codim< codim >::template Partition< pitype >::LeafIterator
     leafbegin ( const unsigned int sweepDir = 0 ) const
@@ -326,6 +352,22 @@ namespace Dune
       return view.impl().template end< codim >( sweepDir );
     }
 
+    template< int codim, PartitionIteratorType pitype >
+    typename Traits::template Codim< codim >::template Partition< pitype >::LeafIterator
+    leafbegin ( const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const
+    {
+      const LeafGridView &view = leafGridView();
+      return view.impl().template begin< codim, pitype >( tileSize, sweepDir );
+    }
+
+    template< int codim >
+    typename Traits::template Codim< codim >::LeafIterator
+    leafbegin ( const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const
+    {
+      const LeafGridView &view = leafGridView();
+      return view.impl().template begin< codim >( tileSize, sweepDir );
+    }
+
     const GlobalIdSet &globalIdSet () const
     {
       return globalIdSet_;
@@ -412,6 +454,15 @@ namespace Dune
 
     const Communication &comm () const;
 
+    /** \brief duplicate of comm() reserved for the grid's point-to-point messages */
+    const Communication &messageComm () const { return messageComm_; }
+
+    /** \brief allocator of message tags for messageComm() */
+    SPTagAllocator &tagAllocator () const { assert( tagAllocator_ ); return *tagAllocator_; }
+
+    /** \brief background progress for messageComm(), shared by all communications */
+    SPProgressThread< Communication > &progressThread () const { assert( progressThread_ ); return *progressThread_; }
+
     template< class Seed >
     typename Traits::template Codim< Seed::codimension >::Entity entity ( const Seed &seed ) const
     {
@@ -457,6 +508,16 @@ namespace Dune
     const GridLevel &gridLevel ( const int level ) const;
     const GridLevel &leafLevel () const;
 
+    /**
+     * \brief attach an observer to be notified about new grid levels
+     *
+     * \note Observers are not transferred when the grid is moved.
+     */
+    void attach ( RefinementObserver &observer ) const;
+
+    /** \brief detach an observer */
+    void detach ( RefinementObserver &observer ) const;
+
     std::size_t numBoundarySegments () const;
 
     static std::string name () { return std::string("SPGrid"); }
@@ -492,9 +553,13 @@ namespace Dune
     GlobalIdSet globalIdSet_;
     LocalIdSet localIdSet_;
     Communication comm_;
+    Communication messageComm_;
+    std::unique_ptr< SPTagAllocator > tagAllocator_;
+    std::unique_ptr< SPProgressThread< Communication > > progressThread_;
     std::size_t boundarySize_;
     std::vector< std::array< std::size_t, 2*dimension > > boundaryOffset_;
     std::array< std::unique_ptr< const typename Codim< 1 >::LocalGeometryImpl >, ReferenceCube::numFaces > localFaceGeometry_;
+    mutable std::vector< RefinementObserver * > observers_;
   };
 
 
@@ -502,8 +567,8 @@ namespace Dune
   // Implementation of SPGrid
   // ------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >
     ::SPGrid ( const Domain &domain, const MultiIndex &cells,
                const Communication &comm )
   : domain_( domain ),
@@ -511,15 +576,18 @@ namespace Dune
     overlap_( MultiIndex::zero() ),
     leafGridView_( LeafGridViewImpl() ),
     hierarchicIndexSet_( *this ),
-    comm_( comm )
+    comm_( comm ),
+    messageComm_( SPCommunicationTraits< Comm >::duplicate( comm ) ),
+    tagAllocator_( new SPTagAllocator( 0, SPCommunicationTraits< Comm >::maxTag( messageComm_ ) ) ),
+    progressThread_( new SPProgressThread< Communication >( messageComm_ ) )
   {
     createLocalGeometries();
     setupMacroGrid();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >
     ::SPGrid ( const Domain &domain, const MultiIndex &cells, const MultiIndex &overlap,
                const Communication &comm )
   : domain_( domain ),
@@ -527,15 +595,18 @@ namespace Dune
     overlap_( overlap ),
     leafGridView_( LeafGridViewImpl() ),
     hierarchicIndexSet_( *this ),
-    comm_( comm )
+    comm_( comm ),
+    messageComm_( SPCommunicationTraits< Comm >::duplicate( comm ) ),
+    tagAllocator_( new SPTagAllocator( 0, SPCommunicationTraits< Comm >::maxTag( messageComm_ ) ) ),
+    progressThread_( new SPProgressThread< Communication >( messageComm_ ) )
   {
     createLocalGeometries();
     setupMacroGrid();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >
     ::SPGrid ( const GlobalVector &a, const GlobalVector &b, const MultiIndex &cells,
                const Communication &comm )
   : domain_( a, b ),
@@ -543,15 +614,18 @@ namespace Dune
     overlap_( MultiIndex::zero() ),
     leafGridView_( LeafGridViewImpl() ),
     hierarchicIndexSet_( *this ),
-    comm_( comm )
+    comm_( comm ),
+    messageComm_( SPCommunicationTraits< Comm >::duplicate( comm ) ),
+    tagAllocator_( new SPTagAllocator( 0, SPCommunicationTraits< Comm >::maxTag( messageComm_ ) ) ),
+    progressThread_( new SPProgressThread< Communication >( messageComm_ ) )
   {
     createLocalGeometries();
     setupMacroGrid();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >
     ::SPGrid ( const GlobalVector &a, const GlobalVector &b, const MultiIndex &cells,
                const MultiIndex &overlap, const Communication &comm )
   : domain_( a, b ),
@@ -559,73 +633,94 @@ namespace Dune
     overlap_( overlap ),
     leafGridView_( LeafGridViewImpl() ),
     hierarchicIndexSet_( *this ),
-    comm_( comm )
+    comm_( comm ),
+    messageComm_( SPCommunicationTraits< Comm >::duplicate( comm ) ),
+    tagAllocator_( new SPTagAllocator( 0, SPCommunicationTraits< Comm >::maxTag( messageComm_ ) ) ),
+    progressThread_( new SPProgressThread< Communication >( messageComm_ ) )
   {
     createLocalGeometries();
     setupMacroGrid();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline SPGrid< ct, dim, Ref, Comm >::SPGrid ( This &&other )
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >::SPGrid ( This &&other )
   : domain_( std::move( other.domain_ ) ),
     globalMesh_( std::move( other.globalMesh_ ) ),
     overlap_( std::move( other.overlap_ ) ),
     leafGridView_( LeafGridViewImpl() ),
     hierarchicIndexSet_( *this ),
-    comm_( std::move( other.comm_ ) )
+    comm_( std::move( other.comm_ ) ),
+    messageComm_( std::move( other.messageComm_ ) ),
+    tagAllocator_( std::move( other.tagAllocator_ ) ),
+    progressThread_( std::move( other.progressThread_ ) )
   {
     createLocalGeometries();
     setupMacroGrid();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline bool SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline SPGrid< ct, dim, Ref, Comm, Index >::~SPGrid ()
+  {
+    for( RefinementObserver *observer : observers_ )
+      observer->grid_ = nullptr;
+
+    // the progress thread probes the duplicated communicator
+    progressThread_.reset();
+
+    // a moved-from grid no longer owns the duplicated communicator
+    if( tagAllocator_ )
+      SPCommunicationTraits< Comm >::free( messageComm_ );
+  }
+
+
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline bool SPGrid< ct, dim, Ref, Comm, Index >
     ::mark ( const int refCount, const typename Codim< 0 >::Entity &e )
   {
     return false;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline int SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline int SPGrid< ct, dim, Ref, Comm, Index >
     ::getMark ( const typename Codim< 0 >::Entity &e ) const
   {
     return 0;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline bool SPGrid< ct, dim, Ref, Comm >::preAdapt ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline bool SPGrid< ct, dim, Ref, Comm, Index >::preAdapt ()
   {
     return false;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline bool SPGrid< ct, dim, Ref, Comm >::adapt ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline bool SPGrid< ct, dim, Ref, Comm, Index >::adapt ()
   {
     return false;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
   template< class DataHandle >
-  inline bool SPGrid< ct, dim, Ref, Comm >
+  inline bool SPGrid< ct, dim, Ref, Comm, Index >
     ::adapt ( AdaptDataHandleInterface< This, DataHandle > &handle )
   {
     return false;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline void SPGrid< ct, dim, Ref, Comm >::postAdapt ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::postAdapt ()
   {}
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline void SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >
     ::globalRefine ( const int refCount, const RefinementPolicy &policy )
   {
     for( int i = 0; i < refCount; ++i )
@@ -635,12 +730,18 @@ namespace Dune
     }
     leafGridView_.impl().update( leafLevel() );
     hierarchicIndexSet_.update();
+
+    for( int level = maxLevel() - refCount + 1; level <= maxLevel(); ++level )
+    {
+      for( RefinementObserver *observer : observers_ )
+        observer->refined( level );
+    }
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
   template< class DataHandle >
-  inline void SPGrid< ct, dim, Ref, Comm >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >
     ::globalRefine ( const int refCount,
                      AdaptDataHandleInterface< This, DataHandle > &handle,
                      const RefinementPolicy &policy )
@@ -655,6 +756,9 @@ namespace Dune
       hierarchicIndexSet_.update();
       leafGridView_.impl().update( leafLevel() );
 
+      for( RefinementObserver *observer : observers_ )
+        observer->refined( maxLevel() );
+
       handle.preAdapt( leafLevel().size() );
       typedef typename Codim< 0 >::LevelIterator LevelIterator;
       const LevelIterator end = fatherView.template end< 0 >();
@@ -665,42 +769,61 @@ namespace Dune
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline const typename SPGrid< ct, dim, Ref, Comm >::Communication &
-  SPGrid< ct, dim, Ref, Comm >::comm () const
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline const typename SPGrid< ct, dim, Ref, Comm, Index >::Communication &
+  SPGrid< ct, dim, Ref, Comm, Index >::comm () const
   {
     return comm_;
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline const typename SPGrid< ct, dim, Ref, Comm >::GridLevel &
-  SPGrid< ct, dim, Ref, Comm >::gridLevel ( const int level ) const
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::attach ( RefinementObserver &observer ) const
+  {
+    if( observer.grid_ )
+      DUNE_THROW( InvalidStateException, "Refinement observer is already attached to a grid." );
+    observer.grid_ = this;
+    observers_.push_back( &observer );
+  }
+
+
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::detach ( RefinementObserver &observer ) const
+  {
+    assert( observer.grid_ == this );
+    observers_.erase( std::remove( observers_.begin(), observers_.end(), &observer ), observers_.end() );
+    observer.grid_ = nullptr;
+  }
+
+
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline const typename SPGrid< ct, dim, Ref, Comm, Index >::GridLevel &
+  SPGrid< ct, dim, Ref, Comm, Index >::gridLevel ( const int level ) const
   {
     assert( (level >= 0) && (level < int( gridLevels_.size() )) );
     return *gridLevels_[ level ];
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline const typename SPGrid< ct, dim, Ref, Comm >::GridLevel &
-  SPGrid< ct, dim, Ref, Comm >::leafLevel () const
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline const typename SPGrid< ct, dim, Ref, Comm, Index >::GridLevel &
+  SPGrid< ct, dim, Ref, Comm, Index >::leafLevel () const
   {
     assert( !gridLevels_.empty() );
     return *gridLevels_.back();
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline std::size_t SPGrid< ct, dim, Ref, Comm >::numBoundarySegments () const
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline std::size_t SPGrid< ct, dim, Ref, Comm, Index >::numBoundarySegments () const
   {
     return boundarySize_;
   }
 
 
   // note: this method ignores the last bit of the macroId
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline std::size_t SPGrid< ct, dim, Ref, Comm >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline std::size_t SPGrid< ct, dim, Ref, Comm, Index >
     ::boundaryIndex ( const MultiIndex &macroId,
                       const unsigned int partitionNumber,
                       const int face ) const
@@ -730,8 +853,8 @@ namespace Dune
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline void SPGrid< ct, dim, Ref, Comm >::createLocalGeometries ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::createLocalGeometries ()
   {
     typedef typename Codim< 1 >::LocalGeometryImpl LocalGeometryImpl;
 
@@ -752,8 +875,8 @@ namespace Dune
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline void SPGrid< ct, dim, Ref, Comm >::setupMacroGrid ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::setupMacroGrid ()
   {
     SPDecomposition< dimension > decomposition( globalMesh_, comm().size() );
 
@@ -766,8 +889,8 @@ namespace Dune
   }
 
 
-  template< class ct, int dim, template< int > class Ref, class Comm >
-  inline void SPGrid< ct, dim, Ref, Comm >::setupBoundaryIndices ()
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index >
+  inline void SPGrid< ct, dim, Ref, Comm, Index >::setupBoundaryIndices ()
   {
     const LevelGridView &macroView = levelGridView( 0 );
     const GridLevel &gridLevel = macroView.impl().gridLevel();
@@ -2,6 +2,7 @@
 #define DUNE_SPGRID_GRIDLEVEL_HH
 
 #include <cassert>
+#include <cstddef>
 #include <vector>
 #include <type_traits>
 
@@ -11,6 +12,7 @@
 #include <dune/grid/spgrid/refinement.hh>
 #include <dune/grid/spgrid/domain.hh>
 #include <dune/grid/spgrid/mesh.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
 #include <dune/grid/spgrid/partitionpool.hh>
 #include <dune/grid/spgrid/linkage.hh>
 #include <dune/grid/spgrid/decomposition.hh>
@@ -62,6 +64,7 @@ namespace Dune
     typedef typename Decomposition::Mesh Mesh;
 
     typedef typename PartitionPool::PartitionList PartitionList;
+    typedef typename PartitionPool::BasicPartitionList BasicPartitionList;
 
     typedef typename Linkage::Interface CommInterface;
 
@@ -92,21 +95,30 @@ namespace Dune
 
     const PartitionList &boundaryPartition ( int face ) const;
 
+    const BasicPartitionList &deepInteriorPartition () const { return partitionPool_.deepInterior(); }
+    const BasicPartitionList &shellPartition () const { return partitionPool_.shell(); }
+
     template< int codim >
     PartitionType
     partitionType ( const MultiIndex &id, const unsigned int partitionNumber ) const;
 
     const CommInterface &commInterface ( const InterfaceType iftype ) const;
 
+    /** \brief pool of message buffers reused by all communications on this level */
+    SPMessageBufferPool &bufferPool () const { return bufferPool_; }
+
     MultiIndex macroId ( const MultiIndex &id ) const;
 
+    /** \brief accumulated refinement factor with respect to the macro level */
+    const MultiIndex &macroFactor () const { return macroFactor_; }
+
     size_t boundaryIndex ( const MultiIndex &id,
                            const unsigned int partitionNumber,
                            const int face ) const;
 
     LocalGeometry geometryInFather ( const MultiIndex &id ) const;
 
-    int size () const;
+    std::size_t size () const;
 
   private:
     void buildLocalGeometry ();
@@ -128,6 +140,7 @@ namespace Dune
     Mesh localMesh_;
     PartitionPool partitionPool_;
     Linkage linkage_;
+    mutable SPMessageBufferPool bufferPool_;
 
     LocalGeometryImpl **geometryInFather_;
 
@@ -292,7 +305,7 @@ namespace Dune
 
 
   template< class Grid >
-  inline int SPGridLevel< Grid >::size () const
+  inline std::size_t SPGridLevel< Grid >::size () const
   {
     return globalMesh().volume();
   }
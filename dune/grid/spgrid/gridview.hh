@@ -2,6 +2,7 @@
 #define DUNE_SPGRID_GRIDVIEW_HH
 
 #include <memory>
+#include <vector>
 #include <type_traits>
 
 #include <dune/grid/common/gridview.hh>
@@ -11,11 +12,15 @@
 #include <dune/grid/spgrid/boundarysegmentiterator.hh>
 #include <dune/grid/spgrid/capabilities.hh>
 #include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/communicationplan.hh>
 #include <dune/grid/spgrid/indexset.hh>
 #include <dune/grid/spgrid/intersection.hh>
 #include <dune/grid/spgrid/intersectioniterator.hh>
 #include <dune/grid/spgrid/iterator.hh>
+#include <dune/grid/spgrid/lineiterator.hh>
 #include <dune/grid/spgrid/superentityiterator.hh>
+#include <dune/grid/spgrid/uniformgeometry.hh>
+#include <dune/grid/spgrid/vectorcommunication.hh>
 
 namespace Dune
 {
@@ -68,6 +73,8 @@ namespace Dune
       typedef typename Partition< All_Partition >::Iterator Iterator;
       typedef typename Partition< All_Partition >::IteratorImpl IteratorImpl;
 
+      typedef SPLineIterator< codim, const Grid > LineIterator;
+
       static const bool hasSuperEntityIterator = true;
       typedef Dune::SuperEntityIterator< const Grid, SPSuperEntityIterator > SuperEntityIterator;
     };
@@ -83,7 +90,7 @@ namespace Dune
   {
     typedef SPGridView< ViewTraits > This;
 
-    template< class, int, template< int > class, class > friend class SPGrid;
+    template< class, int, template< int > class, class, class > friend class SPGrid;
     template< class > friend class SPGridView;
 
   public:
@@ -95,6 +102,9 @@ namespace Dune
     typedef Communication CollectiveCommunication;
 
     typedef SPGridLevel< Grid > GridLevel;
+    typedef typename GridLevel::MultiIndex MultiIndex;
+
+    typedef typename IndexSet::Ordering Ordering;
 
     template< int codim >
     struct Codim
@@ -110,15 +120,46 @@ namespace Dune
 
     explicit SPGridView ( const GridLevel &gridLevel ) : indexSet_( new IndexSet( gridLevel ) ) {}
 
+    SPGridView ( const GridLevel &gridLevel, const Ordering &ordering, bool ownedFirst = false )
+      : indexSet_( std::make_shared< IndexSet >( gridLevel, ordering, ownedFirst ) )
+    {}
+
   public:
     const Grid &grid () const;
 
     const IndexSet &indexSet () const;
 
+    /**
+     * \brief obtain a copy of this view using a different entity ordering
+     *
+     * The returned view shares the grid level, but owns an index set that
+     * numbers the entities of each partition along the given ordering. Its
+     * iterators traverse the entities in the same order; sweep directions and
+     * tile sizes are ignored for such views.
+     */
+    This ordered ( const Ordering &ordering ) const { return This( gridLevel(), ordering ); }
+
+    /**
+     * \brief obtain a copy of this view numbering the interior border entities first
+     *
+     * The returned view shares the grid level, but owns an index set that
+     * numbers the interior border entities contiguously before the overlap
+     * and front entities (see SPIndexSet::isOwnedFirst). The traversal order
+     * is not changed.
+     */
+    This ownedFirst () const { return This( gridLevel(), Ordering(), true ); }
+
+    /** \brief geometry data shared by all elements of this view, evaluated for a quadrature rule */
+    SPUniformGeometry< typename Grid::ctype, Grid::dimension >
+    uniformGeometry ( const QuadratureRule< typename Grid::ctype, Grid::dimension > &quadrature ) const
+    {
+      return SPUniformGeometry< typename Grid::ctype, Grid::dimension >( gridLevel(), quadrature );
+    }
+
     bool isConforming() const { return bool(ViewTraits::conforming); }
 
-    int size ( int codim ) const;
-    int size ( const GeometryType &type ) const;
+    typename IndexSet::IndexType size ( int codim ) const;
+    typename IndexSet::IndexType size ( const GeometryType &type ) const;
 
     int overlapSize ( const int codim ) const;
     int ghostSize ( const int codim ) const;
@@ -139,6 +180,56 @@ namespace Dune
     typename Codim< codim >::template Partition< pitype >::Iterator
     end ( const unsigned int sweepDir = 0 ) const;
 
+    template< int codim >
+    typename Codim< codim >::Iterator
+    begin ( const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const;
+
+    template< int codim, PartitionIteratorType pitype >
+    typename Codim< codim >::template Partition< pitype >::Iterator
+    begin ( const MultiIndex &tileSize, const unsigned int sweepDir = 0 ) const;
+
+    /**
+     * \brief iterate over the interior entities that do not depend on overlap
+     *        data (see SPPartitionPool::deepInterior)
+     *
+     * Together with the shell, the deep interior covers the interior border
+     * partition. This allows to overlap communication with computation:
+     * \code
+     * auto communication = gridView.communicate( dataHandle, iftype, dir );
+     * // update deep interior
+     * communication.wait();
+     * // update shell
+     * \endcode
+     */
+    template< int codim >
+    typename Codim< codim >::Iterator deepInteriorBegin () const;
+
+    template< int codim >
+    typename Codim< codim >::Iterator deepInteriorEnd () const;
+
+    /** \brief iterate over the interior border entities that may depend on overlap data */
+    template< int codim >
+    typename Codim< codim >::Iterator shellBegin () const;
+
+    template< int codim >
+    typename Codim< codim >::Iterator shellEnd () const;
+
+    /**
+     * \brief iterate over runs of entities along axis 0
+     *
+     * Each line provides the index of its first entity, its length and the
+     * index stride, so that kernels can loop over contiguous data without
+     * constructing entities. The lines are visited in the order of the
+     * default (untiled) traversal.
+     *
+     * \note This requires the lexicographic ordering.
+     */
+    template< int codim, PartitionIteratorType pitype = All_Partition >
+    typename Codim< codim >::LineIterator lineBegin () const;
+
+    template< int codim, PartitionIteratorType pitype = All_Partition >
+    typename Codim< codim >::LineIterator lineEnd () const;
+
     IntersectionIterator ibegin ( const typename Codim< 0 >::Entity &entity ) const;
     IntersectionIterator iend ( const typename Codim< 0 >::Entity &entity ) const;
 
@@ -162,6 +253,30 @@ namespace Dune
       return SPCommunication< Grid, CommDataHandleIF< DataHandle, Data > >( gridLevel(), data, iftype, dir );
     }
 
+    /** \brief communicate a vector holding one value per entity of given codimension (see SPVectorCommunication) */
+    template< class T >
+    SPVectorCommunication< Grid, T >
+    communicate ( std::vector< T > &data, int codim, InterfaceType iftype, CommunicationDirection dir ) const
+    {
+      return communicate( data, codim, 1, iftype, dir );
+    }
+
+    /** \brief communicate a vector holding blockSize consecutive values per entity of given codimension */
+    template< class T >
+    SPVectorCommunication< Grid, T >
+    communicate ( std::vector< T > &data, int codim, int blockSize, InterfaceType iftype, CommunicationDirection dir ) const
+    {
+      return SPVectorCommunication< Grid, T >( indexSet(), data, codim, blockSize, iftype, dir );
+    }
+
+    /** \brief set up a reusable communication with persistent requests (see SPCommunicationPlan) */
+    template< class DataHandle, class Data >
+    SPCommunicationPlan< Grid, CommDataHandleIF< DataHandle, Data > >
+    communicationPlan ( CommDataHandleIF< DataHandle, Data > &data, InterfaceType iftype, CommunicationDirection dir ) const
+    {
+      return SPCommunicationPlan< Grid, CommDataHandleIF< DataHandle, Data > >( gridLevel(), data, iftype, dir );
+    }
+
     const GridLevel &gridLevel () const { return indexSet().gridLevel(); }
 
     void update ( const GridLevel &gridLevel ) { assert( indexSet_ ); indexSet_->update( gridLevel ); }
@@ -192,14 +307,16 @@ namespace Dune
 
 
   template< class ViewTraits >
-  inline int SPGridView< ViewTraits >::size ( int codim ) const
+  inline typename SPGridView< ViewTraits >::IndexSet::IndexType
+  SPGridView< ViewTraits >::size ( int codim ) const
   {
     return indexSet().size( codim );
   }
 
 
   template< class ViewTraits >
-  inline int SPGridView< ViewTraits >::size ( const GeometryType &type ) const
+  inline typename SPGridView< ViewTraits >::IndexSet::IndexType
+  SPGridView< ViewTraits >::size ( const GeometryType &type ) const
   {
     return indexSet().size( type );
   }
@@ -210,7 +327,7 @@ namespace Dune
   {
     if( codim != 0 )
       DUNE_THROW( NotImplemented, "overlapSize not implemented for codim > 0." );
-    int volume = gridLevel().template partition< OverlapFront_Partition >().volume();
+    std::size_t volume = gridLevel().template partition< OverlapFront_Partition >().volume();
     volume -= gridLevel().template partition< InteriorBorder_Partition >().volume();
     return volume;
   }
@@ -232,6 +349,8 @@ namespace Dune
   {
     typedef typename Codim< codim >::IteratorImpl IteratorImpl;
     typename IteratorImpl::Begin begin;
+    if( indexSet().partitionOrdering() )
+      return IteratorImpl( gridLevel(), gridLevel().template partition< All_Partition >(), begin, *indexSet().partitionOrdering() );
     return IteratorImpl( gridLevel(), gridLevel().template partition< All_Partition >(), begin, sweepDir );
   }
 
@@ -254,6 +373,8 @@ namespace Dune
   {
     typedef typename Codim< codim >::template Partition< pitype >::IteratorImpl IteratorImpl;
     typename IteratorImpl::Begin begin;
+    if( indexSet().partitionOrdering() )
+      return IteratorImpl( gridLevel(), gridLevel().template partition< pitype >(), begin, *indexSet().partitionOrdering() );
     return IteratorImpl( gridLevel(), gridLevel().template partition< pitype >(), begin, sweepDir );
   }
 
@@ -269,6 +390,98 @@ namespace Dune
   }
 
 
+  template< class ViewTraits >
+  template< int codim >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::Iterator
+  SPGridView< ViewTraits >::begin ( const MultiIndex &tileSize, const unsigned int sweepDir ) const
+  {
+    typedef typename Codim< codim >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::Begin begin;
+    if( indexSet().partitionOrdering() )
+      return IteratorImpl( gridLevel(), gridLevel().template partition< All_Partition >(), begin, *indexSet().partitionOrdering() );
+    return IteratorImpl( gridLevel(), gridLevel().template partition< All_Partition >(), begin, tileSize, sweepDir );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim, PartitionIteratorType pitype >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::template Partition< pitype >::Iterator
+  SPGridView< ViewTraits >::begin ( const MultiIndex &tileSize, const unsigned int sweepDir ) const
+  {
+    typedef typename Codim< codim >::template Partition< pitype >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::Begin begin;
+    if( indexSet().partitionOrdering() )
+      return IteratorImpl( gridLevel(), gridLevel().template partition< pitype >(), begin, *indexSet().partitionOrdering() );
+    return IteratorImpl( gridLevel(), gridLevel().template partition< pitype >(), begin, tileSize, sweepDir );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::Iterator
+  SPGridView< ViewTraits >::deepInteriorBegin () const
+  {
+    typedef typename Codim< codim >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::Begin begin;
+    return IteratorImpl( gridLevel(), gridLevel().deepInteriorPartition(), begin );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::Iterator
+  SPGridView< ViewTraits >::deepInteriorEnd () const
+  {
+    typedef typename Codim< codim >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::End end;
+    return IteratorImpl( gridLevel(), gridLevel().deepInteriorPartition(), end );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::Iterator
+  SPGridView< ViewTraits >::shellBegin () const
+  {
+    typedef typename Codim< codim >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::Begin begin;
+    return IteratorImpl( gridLevel(), gridLevel().shellPartition(), begin );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::Iterator
+  SPGridView< ViewTraits >::shellEnd () const
+  {
+    typedef typename Codim< codim >::IteratorImpl IteratorImpl;
+    typename IteratorImpl::End end;
+    return IteratorImpl( gridLevel(), gridLevel().shellPartition(), end );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim, PartitionIteratorType pitype >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::LineIterator
+  SPGridView< ViewTraits >::lineBegin () const
+  {
+    typedef typename Codim< codim >::LineIterator LineIterator;
+    typename LineIterator::Begin begin;
+    return LineIterator( indexSet(), gridLevel().template partition< pitype >(), begin );
+  }
+
+
+  template< class ViewTraits >
+  template< int codim, PartitionIteratorType pitype >
+  inline typename SPGridView< ViewTraits >::template Codim< codim >::LineIterator
+  SPGridView< ViewTraits >::lineEnd () const
+  {
+    typedef typename Codim< codim >::LineIterator LineIterator;
+    typename LineIterator::End end;
+    return LineIterator( indexSet(), gridLevel().template partition< pitype >(), end );
+  }
+
+
   template< class ViewTraits >
   inline typename SPGridView< ViewTraits >::IntersectionIterator
   SPGridView< ViewTraits >::ibegin ( const typename Codim< 0 >::Entity &entity ) const
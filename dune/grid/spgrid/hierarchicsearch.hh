@@ -195,12 +195,12 @@ namespace Dune
   // HierarchicSearch for SPGrid
   // ---------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm, class IndexSet >
-  class HierarchicSearch< SPGrid< ct, dim, Ref, Comm >, IndexSet >
-    : public SPHierarchicSearch< SPGrid< ct, dim, Ref, Comm >, IndexSet >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index, class IndexSet >
+  class HierarchicSearch< SPGrid< ct, dim, Ref, Comm, Index >, IndexSet >
+    : public SPHierarchicSearch< SPGrid< ct, dim, Ref, Comm, Index >, IndexSet >
   {
-    typedef SPHierarchicSearch< SPGrid< ct, dim, Ref, Comm >, IndexSet > Base;
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPHierarchicSearch< SPGrid< ct, dim, Ref, Comm, Index >, IndexSet > Base;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
   public:
     typedef typename Base::Entity Entity;
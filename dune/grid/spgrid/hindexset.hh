@@ -15,10 +15,10 @@ namespace Dune
 
   template< class Grid >
   class SPHierarchyIndexSet
-    : public IndexSet< Grid, SPHierarchyIndexSet< Grid >, unsigned int, std::array< GeometryType, 1 > >
+    : public IndexSet< Grid, SPHierarchyIndexSet< Grid >, typename std::remove_const< Grid >::type::Traits::IndexType, std::array< GeometryType, 1 > >
   {
     typedef SPHierarchyIndexSet< Grid > This;
-    typedef IndexSet< Grid, This, unsigned int, std::array< GeometryType, 1 > > Base;
+    typedef IndexSet< Grid, This, typename std::remove_const< Grid >::type::Traits::IndexType, std::array< GeometryType, 1 > > Base;
 
     typedef typename std::remove_const< Grid >::type::Traits Traits;
 
@@ -43,6 +43,8 @@ namespace Dune
 
     static const int levelShift = 8*sizeof( IdType ) - 8;
 
+    static bool isCopy ( const MultiIndex &id, const MultiIndex &fineFactor, const MultiIndex &coarseFactor );
+
     IdType computeId ( const GridLevel &gridLevel, const MultiIndex &id ) const;
 
     template< int cd >
@@ -82,33 +84,76 @@ namespace Dune
       const GridLevel &gridLevel = entityInfo.gridLevel();
       return computeSubId( gridLevel, entityInfo.id(), i, codim, std::integral_constant< int, cd >() );
     }
+
+    /**
+     * \brief compute the ids of a range of entities
+     *
+     * \param[in]   first  iterator to the first entity
+     * \param[in]   last   iterator behind the last entity
+     * \param[out]  out    output iterator receiving the ids
+     *
+     * \returns output iterator behind the last id written
+     */
+    template< class InputIterator, class OutputIterator >
+    OutputIterator ids ( InputIterator first, InputIterator last, OutputIterator out ) const
+    {
+      for( ; first != last; ++first, ++out )
+        *out = id( *first );
+      return out;
+    }
   };
 
 
+
+  // Implementation of SPLocalIdSet
+  // ------------------------------
+
+  template< class Grid >
+  inline bool SPLocalIdSet< Grid >
+    ::isCopy ( const MultiIndex &id, const MultiIndex &fineFactor, const MultiIndex &coarseFactor )
+  {
+    // the entity is a copy on all intermediate levels, iff each even component
+    // is divisible by twice the refinement factor in between (odd components
+    // must not be refined at all)
+    bool copy = true;
+    for( int i = 0; i < dimension; ++i )
+    {
+      const int alpha = fineFactor[ i ] / coarseFactor[ i ];
+      copy &= ((id[ i ] & 1) ? (alpha == 1) : (id[ i ] % (2*alpha) == 0));
+    }
+    return copy;
+  }
+
+
   template< class Grid >
   typename SPLocalIdSet< Grid >::IdType
   inline SPLocalIdSet< Grid >
     ::computeId ( const GridLevel &gridLevel, const MultiIndex &id ) const
   {
-    const unsigned int level = gridLevel.level();
-    if( (level > 0) && gridLevel.refinement().isCopy( id ) )
+    // find the coarsest level the entity is a copy of (bisection on the levels)
+    const Grid &grid = gridLevel.grid();
+    const MultiIndex &macroFactor = gridLevel.macroFactor();
+    int coarse = 0, fine = gridLevel.level();
+    while( coarse < fine )
     {
-      const Grid &grid = gridLevel.grid();
-      MultiIndex fatherId( id );
-      gridLevel.refinement().father( fatherId );
-      return computeId( grid.gridLevel( level-1 ), fatherId );
+      const int level = (coarse + fine) / 2;
+      if( isCopy( id, macroFactor, grid.gridLevel( level ).macroFactor() ) )
+        fine = level;
+      else
+        coarse = level+1;
     }
 
-    const Mesh &globalMesh = gridLevel.globalMesh();
+    const GridLevel &coarseLevel = grid.gridLevel( fine );
+    const Mesh &globalMesh = coarseLevel.globalMesh();
 
     IdType index = 0;
     IdType factor = 1;
     for( int i = 0; i < dimension; ++i )
     {
-      index += IdType( id[ i ] ) * factor;
+      index += IdType( id[ i ] / (macroFactor[ i ] / coarseLevel.macroFactor()[ i ]) ) * factor;
       factor *= IdType( 2*globalMesh.width( i ) + 1 );
     }
-    return index | (IdType( level ) << levelShift);
+    return index | (IdType( fine ) << levelShift);
   }
 
 
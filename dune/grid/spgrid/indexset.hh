@@ -1,24 +1,109 @@
 #ifndef DUNE_SPGRID_INDEXSET_HH
 #define DUNE_SPGRID_INDEXSET_HH
 
+#include <algorithm>
 #include <array>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#include <dune/common/exceptions.hh>
+
 #include <dune/grid/common/indexidset.hh>
 
 #include <dune/grid/spgrid/entityinfo.hh>
+#include <dune/grid/spgrid/entityseed.hh>
 #include <dune/grid/spgrid/gridlevel.hh>
+#include <dune/grid/spgrid/ordering.hh>
 
 namespace Dune
 {
 
+  // SPIndexLayout
+  // -------------
+
+  /**
+   * \class SPIndexLayout
+   * \brief affine layout of the indices of the entities with one direction in
+   *        one partition
+   *
+   * For an entity with multi index id, the index is given by
+   * \f[
+   *   \mathrm{offset} + \sum_i \frac{id_i - begin_i}{2} \mathrm{stride}_i.
+   * \f]
+   * Hence, the index of a neighboring entity with the same direction, i.e.,
+   * id + 2 e_i, is obtained by adding stride( i ).
+   */
+  template< int dim, class Index >
+  class SPIndexLayout
+  {
+    typedef SPIndexLayout< dim, Index > This;
+
+  public:
+    static const int dimension = dim;
+
+    typedef Index IndexType;
+    typedef SPMultiIndex< dimension > MultiIndex;
+
+    SPIndexLayout () = default;
+
+    SPIndexLayout ( IndexType offset, const MultiIndex &begin, const MultiIndex &end, const std::array< IndexType, dimension > &stride )
+      : offset_( offset ), begin_( begin ), end_( end ), stride_( stride )
+    {}
+
+    /** \brief index of the entity with multi index begin() */
+    IndexType offset () const { return offset_; }
+
+    /** \brief smallest multi index of the entities */
+    const MultiIndex &begin () const { return begin_; }
+    /** \brief largest multi index of the entities */
+    const MultiIndex &end () const { return end_; }
+
+    /** \brief index increment for a step of 2 in the i-th component of the multi index */
+    IndexType stride ( int i ) const { return stride_[ i ]; }
+    const std::array< IndexType, dimension > &stride () const { return stride_; }
+
+    bool contains ( const MultiIndex &id ) const
+    {
+      bool contains = true;
+      for( int i = 0; i < dimension; ++i )
+        contains &= (id[ i ] >= begin()[ i ]) && (id[ i ] <= end()[ i ]) && (((id[ i ] - begin()[ i ]) & 1) == 0);
+      return contains;
+    }
+
+    /** \brief lexicographic index of an entity relative to offset() */
+    IndexType local ( const MultiIndex &id ) const
+    {
+      assert( contains( id ) );
+      IndexType local = 0;
+      for( int i = 0; i < dimension; ++i )
+        local += IndexType( (id[ i ] - begin()[ i ]) >> 1 ) * stride( i );
+      return local;
+    }
+
+    IndexType index ( const MultiIndex &id ) const { return offset() + local( id ); }
+
+  private:
+    IndexType offset_ = 0;
+    MultiIndex begin_, end_;
+    std::array< IndexType, dimension > stride_;
+  };
+
+
+
+  // SPIndexSet
+  // ----------
+
   template< class Grid >
   class SPIndexSet
-    : public IndexSet< Grid, SPIndexSet< Grid >, unsigned int, std::array< GeometryType, 1 > >
+    : public IndexSet< Grid, SPIndexSet< Grid >, typename std::remove_const< Grid >::type::Traits::IndexType, std::array< GeometryType, 1 > >
   {
     typedef SPIndexSet< Grid > This;
-    typedef IndexSet< Grid, This, unsigned int, std::array< GeometryType, 1 > > Base;
+    typedef IndexSet< Grid, This, typename std::remove_const< Grid >::type::Traits::IndexType, std::array< GeometryType, 1 > > Base;
+
+    template< int, class >
+    friend class SPLineIterator;
 
     typedef typename std::remove_const< Grid >::type::Traits Traits;
 
@@ -38,19 +123,48 @@ namespace Dune
     typedef SPGridLevel< typename std::remove_const< Grid >::type > GridLevel;
     typedef typename GridLevel::PartitionList PartitionList;
 
-  private:
+    typedef SPOrdering< dimension > Ordering;
+    typedef SPPartitionOrdering< dimension, IndexType > PartitionOrdering;
+
+    typedef SPIndexLayout< dimension, IndexType > Layout;
+
     typedef typename GridLevel::MultiIndex MultiIndex;
+
+  private:
     typedef typename PartitionList::Partition Partition;
 
+    struct Block
+    {
+      Layout layout;
+      unsigned int number, dir;
+    };
+
   public:
     SPIndexSet () = default;
     explicit SPIndexSet ( const GridLevel &gridLevel ) { update( gridLevel ); }
 
+    /**
+     * \brief constructor
+     *
+     * \param[in]  gridLevel   grid level to index
+     * \param[in]  ordering    ordering of the entities within each partition
+     * \param[in]  ownedFirst  number the interior border entities before all
+     *                         other entities (requires lexicographic ordering)
+     */
+    SPIndexSet ( const GridLevel &gridLevel, const Ordering &ordering, bool ownedFirst = false )
+      : ordering_( ordering ), ownedFirst_( ownedFirst )
+    {
+      update( gridLevel );
+    }
+
     void update ( const GridLevel &gridLevel );
 
   private:
     IndexType index ( const MultiIndex &id, unsigned int number ) const;
 
+    const Layout &box ( const MultiIndex &id, unsigned int number, unsigned int dir ) const;
+    Layout addBox ( const MultiIndex &begin, const MultiIndex &end, unsigned int number, unsigned int dir );
+
     template< int cd >
     IndexType subIndex ( const MultiIndex &id, int i, int codim, unsigned int number, std::integral_constant< int, cd > ) const;
     IndexType subIndex ( const MultiIndex &id, int i, int codim, unsigned int number, std::integral_constant< int, 0 > ) const;
@@ -84,11 +198,59 @@ namespace Dune
 
     const PartitionList &partitions () const { assert( partitions_ ); return *partitions_; }
 
+    const Ordering &ordering () const { return ordering_; }
+
+    /** \brief traversal order of the partitions (nullptr for lexicographic ordering) */
+    const PartitionOrdering *partitionOrdering () const { return partitionOrdering_.get(); }
+
+    /**
+     * \brief are the interior border entities numbered first?
+     *
+     * If so, the indices of the interior border entities of codimension
+     * codim form the range [ 0, ownedSize( codim ) [, while the overlap and
+     * front entities occupy the remaining indices.
+     */
+    bool isOwnedFirst () const { return ownedFirst_; }
+
+    /** \brief number of interior border entities (requires owned-first numbering) */
+    IndexType ownedSize ( int codim ) const;
+
+    /**
+     * \brief index layout of the entities with given direction in a partition
+     *
+     * \note The layout describes the indices only for the lexicographic ordering.
+     *       For owned-first numbering, it only describes the interior border
+     *       entities of the partition (if there are any).
+     */
+    const Layout &layout ( unsigned int number, unsigned int dir ) const;
+
+    /** \brief index layout of the entities with the same partition and direction as an entity, containing the entity */
+    template< class Entity >
+    const Layout &layout ( const Entity &entity ) const;
+
+    /**
+     * \brief obtain multi index and partition number of an entity from its index
+     *
+     * This is the inverse of the index map. The block containing the index is
+     * determined by binary search.
+     */
+    std::pair< MultiIndex, unsigned int > multiIndex ( int codim, IndexType index ) const;
+
+    /** \brief obtain the entity seed of an entity from its index */
+    template< int codim >
+    typename Traits::template Codim< codim >::EntitySeed seed ( IndexType index ) const;
+
   private:
     const GridLevel *gridLevel_ = nullptr;
     const PartitionList *partitions_ = nullptr;
-    std::vector< std::array< IndexType, 1 << dimension > > offsets_;
+    Ordering ordering_;
+    bool ownedFirst_ = false;
+    std::shared_ptr< const PartitionOrdering > partitionOrdering_;
+    std::vector< std::array< Layout, 1 << dimension > > layouts_;
+    std::vector< std::array< std::vector< Layout >, 1 << dimension > > haloLayouts_;
+    std::array< std::vector< Block >, dimension+1 > blocks_;
     IndexType size_[ dimension+1 ];
+    IndexType ownedSize_[ dimension+1 ];
   };
 
 
@@ -103,27 +265,132 @@ namespace Dune
     partitions_ = &gridLevel.template partition< All_Partition >();
 
     for( int codim = 0; codim <= dimension; ++codim )
+    {
       size_[ codim ] = 0;
+      blocks_[ codim ].clear();
+    }
+
+    if( ownedFirst_ && !ordering().isLexicographic() )
+      DUNE_THROW( NotImplemented, "Owned-first numbering requires lexicographic ordering (got " << ordering().name() << ")." );
+
+    const unsigned int numPartitions = partitions().maxNumber() - partitions().minNumber() + 1;
+    layouts_.resize( numPartitions );
+    haloLayouts_.clear();
+
+    // owned-first numbering: number the interior border part of each partition first
+    const PartitionList &owned = gridLevel.template partition< InteriorBorder_Partition >();
+    if( ownedFirst_ )
+    {
+      haloLayouts_.resize( numPartitions );
+      for( typename PartitionList::Iterator pit = partitions().begin(); pit; ++pit )
+      {
+        if( !owned.contains( pit->number() ) )
+          continue;
+
+        const Partition &ownedPartition = owned.partition( pit->number() );
+        for( unsigned int dir = 0; dir < (1 << dimension); ++dir )
+        {
+          MultiIndex begin, end;
+          for( int j = 0; j < dimension; ++j )
+          {
+            const unsigned int d = (dir >> j) & 1;
+            begin[ j ] = std::max( pit->bound( 0, j, d ), ownedPartition.bound( 0, j, d ) );
+            end[ j ] = std::min( pit->bound( 1, j, d ), ownedPartition.bound( 1, j, d ) );
+          }
+          layouts_[ pit->number() - partitions().minNumber() ][ dir ] = addBox( begin, end, pit->number(), dir );
+        }
+      }
+    }
+
+    for( int codim = 0; codim <= dimension; ++codim )
+      ownedSize_[ codim ] = size_[ codim ];
 
-    offsets_.resize( partitions().maxNumber() - partitions().minNumber() + 1 );
     for( typename PartitionList::Iterator pit = partitions().begin(); pit; ++pit )
     {
       for( unsigned int dir = 0; dir < (1 << dimension); ++dir )
       {
-        IndexType factor = 1;
-        unsigned int codim = dimension;
+        MultiIndex begin, end;
         for( int j = 0; j < dimension; ++j )
         {
           const unsigned int d = (dir >> j) & 1;
-          const int w = pit->bound( 1, j, d ) - pit->bound( 0, j, d );
-          assert( w % 2 == 0 );
-          factor *= (w / 2 + 1);
-          codim -= d;
+          begin[ j ] = pit->bound( 0, j, d );
+          end[ j ] = pit->bound( 1, j, d );
+        }
+
+        Layout &layout = layouts_[ pit->number() - partitions().minNumber() ][ dir ];
+        if( !ownedFirst_ || !owned.contains( pit->number() ) )
+        {
+          layout = addBox( begin, end, pit->number(), dir );
+          continue;
+        }
+
+        // the remaining entities consist of (at most) two slabs per axis
+        std::vector< Layout > &halo = haloLayouts_[ pit->number() - partitions().minNumber() ][ dir ];
+        for( int i = 0; i < dimension; ++i )
+        {
+          if( layout.begin()[ i ] > begin[ i ] )
+          {
+            MultiIndex slabEnd = end;
+            slabEnd[ i ] = layout.begin()[ i ]-2;
+            halo.push_back( addBox( begin, slabEnd, pit->number(), dir ) );
+            begin[ i ] = layout.begin()[ i ];
+          }
+          if( layout.end()[ i ] < end[ i ] )
+          {
+            MultiIndex slabBegin = begin;
+            slabBegin[ i ] = layout.end()[ i ]+2;
+            halo.push_back( addBox( slabBegin, end, pit->number(), dir ) );
+            end[ i ] = layout.end()[ i ];
+          }
         }
-        offsets_[ pit->number() - partitions().minNumber() ][ dir ] = size_[ codim ];
-        size_[ codim ] += factor;
       }
     }
+
+    partitionOrdering_.reset();
+    if( !ordering().isLexicographic() )
+      partitionOrdering_ = std::make_shared< const PartitionOrdering >( ordering(), partitions() );
+  }
+
+
+  template< class Grid >
+  inline typename SPIndexSet< Grid >::Layout
+  SPIndexSet< Grid >::addBox ( const MultiIndex &begin, const MultiIndex &end, unsigned int number, unsigned int dir )
+  {
+    std::array< IndexType, dimension > stride;
+    IndexType factor = 1;
+    unsigned int codim = dimension;
+    for( int j = 0; j < dimension; ++j )
+    {
+      const int w = end[ j ] - begin[ j ];
+      assert( w % 2 == 0 );
+      stride[ j ] = factor;
+      factor *= std::max( w / 2 + 1, 0 );
+      codim -= (dir >> j) & 1;
+    }
+
+    const Layout layout( size_[ codim ], begin, end, stride );
+    if( factor > 0 )
+      blocks_[ codim ].push_back( Block{ layout, number, dir } );
+    size_[ codim ] += factor;
+    return layout;
+  }
+
+
+  template< class Grid >
+  inline const typename SPIndexSet< Grid >::Layout &
+  SPIndexSet< Grid >::box ( const MultiIndex &id, unsigned int number, unsigned int dir ) const
+  {
+    const Layout &layout = layouts_[ number - partitions().minNumber() ][ dir ];
+    if( !ownedFirst_ || layout.contains( id ) )
+      return layout;
+
+    for( const Layout &halo : haloLayouts_[ number - partitions().minNumber() ][ dir ] )
+    {
+      if( halo.contains( id ) )
+        return halo;
+    }
+    assert( false );
+    return layout;
   }
 
 
@@ -131,27 +398,87 @@ namespace Dune
   inline typename SPIndexSet< Grid >::IndexType
   SPIndexSet< Grid >::index ( const MultiIndex &id, unsigned int number ) const
   {
-    const Partition &partition = partitions().partition( number );
-
-    IndexType index = 0;
-    IndexType factor = 1;
     unsigned int dir = 0;
     for( int j = 0; j < dimension; ++j )
-    {
-      const unsigned int d = id[ j ] & 1;
-      dir |= (d << j);
+      dir |= ((id[ j ] & 1) << j);
+
+    const Layout &layout = box( id, number, dir );
+    IndexType index = layout.local( id );
+    if( partitionOrdering_ )
+      index = partitionOrdering_->rank( number, dir, index );
+    return layout.offset() + index;
+  }
+
+
+  template< class Grid >
+  inline const typename SPIndexSet< Grid >::Layout &
+  SPIndexSet< Grid >::layout ( unsigned int number, unsigned int dir ) const
+  {
+    if( partitionOrdering_ )
+      DUNE_THROW( InvalidStateException, "Index layout requires lexicographic ordering (got " << ordering().name() << ")." );
+    assert( partitions().contains( number ) && (dir < (1u << dimension)) );
+    return layouts_[ number - partitions().minNumber() ][ dir ];
+  }
 
-      const int begin = partition.bound( 0, j, d );
-      const int end = partition.bound( 1, j, d );
 
-      const IndexType idLocal = (id[ j ] - begin) >> 1;
-      const IndexType width = ((end - begin) >> 1) + 1;
-      assert( (idLocal >= 0) && (idLocal < width) );
-      index += idLocal * factor;
+  template< class Grid >
+  template< class Entity >
+  inline const typename SPIndexSet< Grid >::Layout &
+  SPIndexSet< Grid >::layout ( const Entity &entity ) const
+  {
+    const auto &entityInfo = entity.impl().entityInfo();
+    const Layout &layout = this->layout( entityInfo.partitionNumber(), entityInfo.direction().bits() );
+    return (ownedFirst_ ? box( entityInfo.id(), entityInfo.partitionNumber(), entityInfo.direction().bits() ) : layout);
+  }
+
+
+  template< class Grid >
+  inline typename SPIndexSet< Grid >::IndexType
+  SPIndexSet< Grid >::ownedSize ( int codim ) const
+  {
+    if( !ownedFirst_ )
+      DUNE_THROW( InvalidStateException, "Owned entities are only numbered contiguously for owned-first numbering." );
+    assert( (codim >= 0) && (codim <= dimension) );
+    return ownedSize_[ codim ];
+  }
 
-      factor *= width;
+
+  template< class Grid >
+  inline std::pair< typename SPIndexSet< Grid >::MultiIndex, unsigned int >
+  SPIndexSet< Grid >::multiIndex ( int codim, IndexType index ) const
+  {
+    assert( (codim >= 0) && (codim <= dimension) && (index < size( codim )) );
+
+    // find the last block with offset <= index
+    const std::vector< Block > &blocks = blocks_[ codim ];
+    auto it = std::upper_bound( blocks.begin(), blocks.end(), index, [] ( IndexType i, const Block &b ) { return (i < b.layout.offset()); } );
+    assert( it != blocks.begin() );
+    const Block &block = *(--it);
+
+    IndexType local = index - block.layout.offset();
+    if( partitionOrdering_ )
+      return std::make_pair( partitionOrdering_->id( block.number, block.dir, local ), block.number );
+
+    const Layout &layout = block.layout;
+    MultiIndex id;
+    for( int j = 0; j < dimension; ++j )
+    {
+      const IndexType width = ((layout.end()[ j ] - layout.begin()[ j ]) >> 1) + 1;
+      id[ j ] = layout.begin()[ j ] + 2*int( local % width );
+      local /= width;
     }
-    return offsets_[ number - partitions().minNumber() ][ dir ] + index;
+    return std::make_pair( id, block.number );
+  }
+
+
+  template< class Grid >
+  template< int codim >
+  inline typename SPIndexSet< Grid >::Traits::template Codim< codim >::EntitySeed
+  SPIndexSet< Grid >::seed ( IndexType index ) const
+  {
+    typedef typename Traits::template Codim< codim >::EntitySeed EntitySeed;
+    const std::pair< MultiIndex, unsigned int > id = multiIndex( codim, index );
+    return EntitySeed( SPEntitySeed< codim, Grid >( gridLevel().level(), id.first, id.second ) );
   }
 
 
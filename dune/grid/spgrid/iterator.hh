@@ -7,6 +7,7 @@
 #include <dune/grid/spgrid/direction.hh>
 #include <dune/grid/spgrid/misc.hh>
 #include <dune/grid/spgrid/entity.hh>
+#include <dune/grid/spgrid/ordering.hh>
 
 namespace Dune
 {
@@ -36,17 +37,32 @@ namespace Dune
     typedef typename EntityImpl::GridLevel GridLevel;
 
     typedef SPPartitionList< dimension > PartitionList;
+    typedef SPPartitionOrdering< dimension, typename Traits::IndexType > PartitionOrdering;
 
     typedef typename EntityInfo::Direction Direction;
+    typedef typename EntityInfo::MultiIndex MultiIndex;
 
     static const unsigned int numDirections = GridLevel::numDirections;
 
     struct Begin {};
     struct End {};
 
-  protected:
-    typedef typename EntityInfo::MultiIndex MultiIndex;
+    /**
+     * \brief color class of entities
+     *
+     * Bit i of the color is the parity of floor( id[ i ] / 2 ). Two cells of
+     * the same color do not share any subentity.
+     */
+    struct Color
+    {
+      explicit Color ( unsigned int b ) : bits( b ) {}
 
+      unsigned int bits;
+    };
+
+    static const unsigned int numColors = (1u << dimension);
+
+  protected:
     typedef SPDirectionIterator< dimension, codimension > DirectionIterator;
 
   public:
@@ -57,6 +73,29 @@ namespace Dune
     SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
                           const End &e, const unsigned int sweepDir = 0 );
 
+    /**
+     * \brief constructor for a tiled traversal
+     *
+     * Each partition is visited in tiles of tileSize[ i ] entities along axis i
+     * (a non-positive size disables tiling along that axis). Within a tile and
+     * between tiles, the order is lexicographic with respect to sweepDir.
+     */
+    SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                          const Begin &b, const MultiIndex &tileSize, const unsigned int sweepDir = 0 );
+
+    /**
+     * \brief constructor for a traversal along a space-filling curve
+     *
+     * The partitions are visited in the order given by the partition ordering,
+     * which has to contain all partitions of the list (see SPIndexSet).
+     */
+    SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                          const Begin &b, const PartitionOrdering &ordering );
+
+    /** \brief constructor for a traversal of the entities of a single color */
+    SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                          const Begin &b, const Color &color );
+
     operator bool () const { return bool( partition_ ); }
 
     Entity operator* () const { return dereference(); }
@@ -80,6 +119,15 @@ namespace Dune
   private:
     int begin ( int i, Direction dir ) const;
     int end ( int i, Direction dir ) const;
+    int tileEnd ( int i, Direction dir ) const;
+    bool empty ( Direction dir ) const;
+
+    void incrementColored ();
+    void incrementTiled ();
+    void incrementOrdered ();
+    void nextDirection ();
+    void nextOrderedDirection ( Direction dir );
+    bool seekOrdered ( Direction dir );
 
     void init ();
 
@@ -87,6 +135,13 @@ namespace Dune
     EntityInfo entityInfo_;
     typename PartitionList::Iterator partition_;
     unsigned int sweepDirection_;
+    bool colored_ = false;
+    unsigned int color_ = 0;
+    bool tiled_ = false;
+    MultiIndex tileSize_;
+    MultiIndex tileBegin_;
+    const PartitionOrdering *ordering_ = nullptr;
+    typename PartitionOrdering::Index position_ = 0;
   };
 
 
@@ -120,9 +175,59 @@ namespace Dune
   }
 
 
+  template< int codim, class Grid >
+  inline SPPartitionIterator< codim, Grid >
+    ::SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                            const Begin &b, const MultiIndex &tileSize, unsigned int sweepDir )
+    : entityInfo_( gridLevel ),
+      partition_( partitionList.begin() ),
+      sweepDirection_( sweepDir ),
+      tiled_( true ),
+      tileSize_( tileSize )
+  {
+    assert( sweepDir < numDirections );
+    init();
+  }
+
+
+  template< int codim, class Grid >
+  inline SPPartitionIterator< codim, Grid >
+    ::SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                            const Begin &b, const PartitionOrdering &ordering )
+    : entityInfo_( gridLevel ),
+      partition_( partitionList.begin() ),
+      sweepDirection_( 0 ),
+      ordering_( &ordering )
+  {
+    init();
+  }
+
+
+  template< int codim, class Grid >
+  inline SPPartitionIterator< codim, Grid >
+    ::SPPartitionIterator ( const GridLevel &gridLevel, const PartitionList &partitionList,
+                            const Begin &b, const Color &color )
+    : entityInfo_( gridLevel ),
+      partition_( partitionList.begin() ),
+      sweepDirection_( 0 ),
+      colored_( true ),
+      color_( color.bits )
+  {
+    assert( color.bits < numColors );
+    init();
+  }
+
+
   template< int codim, class Grid >
   inline void SPPartitionIterator< codim, Grid >::increment ()
   {
+    if( ordering_ )
+      return incrementOrdered();
+    if( colored_ )
+      return incrementColored();
+    if( tiled_ )
+      return incrementTiled();
+
     MultiIndex &id = entityInfo().id();
     for( int i = 0; i < dimension; ++i )
     {
@@ -133,14 +238,119 @@ namespace Dune
       id[ i ] = begin( i, entityInfo().direction() );
     }
 
+    nextDirection();
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPPartitionIterator< codim, Grid >::incrementColored ()
+  {
+    // skip the entities of other colors
+    MultiIndex &id = entityInfo().id();
+    const Direction dir = entityInfo().direction();
+    for( int i = 0; i < dimension; ++i )
+    {
+      id[ i ] += 4;
+      if( id[ i ] <= partition_->bound( 1, i, dir[ i ] ) )
+        return entityInfo().update();
+      id[ i ] = begin( i, dir );
+    }
+
+    nextDirection();
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPPartitionIterator< codim, Grid >::incrementTiled ()
+  {
+    MultiIndex &id = entityInfo().id();
+    const Direction dir = entityInfo().direction();
+
+    // advance within the current tile
+    for( int i = 0; i < dimension; ++i )
+    {
+      const unsigned int sweep = (sweepDirection_ >> i) & 1;
+      id[ i ] += (2 - 4*sweep);
+      if( id[ i ] != tileEnd( i, dir ) )
+        return entityInfo().update();
+      id[ i ] = tileBegin_[ i ];
+    }
+
+    // advance to the next tile
+    for( int i = 0; i < dimension; ++i )
+    {
+      tileBegin_[ i ] = tileEnd( i, dir );
+      if( tileBegin_[ i ] != end( i, dir ) )
+      {
+        id[ i ] = tileBegin_[ i ];
+        return entityInfo().update();
+      }
+      id[ i ] = tileBegin_[ i ] = begin( i, dir );
+    }
+
+    nextDirection();
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPPartitionIterator< codim, Grid >::incrementOrdered ()
+  {
+    const Direction dir = entityInfo().direction();
+    ++position_;
+    if( seekOrdered( dir ) )
+      entityInfo().update();
+    else
+      nextOrderedDirection( dir );
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPPartitionIterator< codim, Grid >::nextOrderedDirection ( Direction dir )
+  {
+    DirectionIterator dirIt( dir );
+    for( ++dirIt; dirIt; ++dirIt )
+    {
+      position_ = 0;
+      if( !partition_->empty( *dirIt ) && seekOrdered( *dirIt ) )
+        return entityInfo().update();
+    }
+
+    ++partition_;
+    init();
+  }
+
+
+  template< int codim, class Grid >
+  inline bool SPPartitionIterator< codim, Grid >::seekOrdered ( Direction dir )
+  {
+    // note: the partition might only be a subset of the ordered partition
+    MultiIndex &id = entityInfo().id();
+    const unsigned int number = partition_->number();
+    const typename PartitionOrdering::Index size = ordering_->size( number, dir.bits() );
+    for( ; position_ < size; ++position_ )
+    {
+      id = ordering_->id( number, dir.bits(), position_ );
+      if( partition_->contains( id ) )
+        return true;
+    }
+    return false;
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPPartitionIterator< codim, Grid >::nextDirection ()
+  {
+    MultiIndex &id = entityInfo().id();
+
     DirectionIterator dirIt( entityInfo().direction() );
     ++dirIt;
-    for( ; dirIt && partition_->empty( *dirIt ); ++dirIt )
+    for( ; dirIt && empty( *dirIt ); ++dirIt )
       continue;
     if( dirIt )
     {
       for( int i = 0; i < dimension; ++i )
         id[ i ] = begin( i, *dirIt );
+      tileBegin_ = id;
       entityInfo().update();
     }
     else
@@ -155,7 +365,10 @@ namespace Dune
   inline int SPPartitionIterator< codim, Grid >::begin ( int i, Direction dir ) const
   {
     const unsigned int s = (sweepDirection_ >> i) & 1;
-    return partition_->bound( s, i, dir[ i ] );
+    const int bnd = partition_->bound( s, i, dir[ i ] );
+    if( colored_ && (((bnd >> 1) & 1) != int( (color_ >> i) & 1 )) )
+      return bnd + 2;
+    return bnd;
   }
 
 
@@ -168,19 +381,57 @@ namespace Dune
   }
 
 
+  template< int codim, class Grid >
+  inline int SPPartitionIterator< codim, Grid >::tileEnd ( int i, Direction dir ) const
+  {
+    const int e = end( i, dir );
+    if( tileSize_[ i ] <= 0 )
+      return e;
+
+    const int step = 2 - 4*int( (sweepDirection_ >> i) & 1 );
+    const int t = tileBegin_[ i ] + step*tileSize_[ i ];
+    return (step > 0 ? std::min( t, e ) : std::max( t, e ));
+  }
+
+
+  template< int codim, class Grid >
+  inline bool SPPartitionIterator< codim, Grid >::empty ( Direction dir ) const
+  {
+    if( !colored_ )
+      return partition_->empty( dir );
+
+    bool empty = false;
+    for( int i = 0; i < dimension; ++i )
+      empty |= (begin( i, dir ) > partition_->bound( 1, i, dir[ i ] ));
+    return empty;
+  }
+
+
   template< int codim, class Grid >
   inline void SPPartitionIterator< codim, Grid >::init ()
   {
     MultiIndex &id = entityInfo().id();
-    if( partition_ )
+    if( partition_ && ordering_ )
+    {
+      for( DirectionIterator dirIt; dirIt; ++dirIt )
+      {
+        position_ = 0;
+        if( !partition_->empty( *dirIt ) && seekOrdered( *dirIt ) )
+          return entityInfo().update( partition_->number() );
+      }
+      ++partition_;
+      init();
+    }
+    else if( partition_ )
     {
       DirectionIterator dirIt;
-      for( ; dirIt && partition_->empty( *dirIt ); ++dirIt )
+      for( ; dirIt && empty( *dirIt ); ++dirIt )
         continue;
       if( dirIt )
       {
         for( int i = 0; i < dimension; ++i )
           id[ i ] = begin( i, *dirIt );
+        tileBegin_ = id;
         entityInfo().update( partition_->number() );
       }
       else
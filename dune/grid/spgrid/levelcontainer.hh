@@ -0,0 +1,300 @@
+#ifndef DUNE_SPGRID_LEVELCONTAINER_HH
+#define DUNE_SPGRID_LEVELCONTAINER_HH
+
+#include <cassert>
+
+#include <type_traits>
+#include <vector>
+
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/multiindex.hh>
+#include <dune/grid/spgrid/refinementobserver.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  level-wise persistent data with prolongation on global refinement
+ */
+
+namespace Dune
+{
+
+  // SPConstantProlongation
+  // ----------------------
+
+  /**
+   * \brief piecewise constant prolongation
+   *
+   * Each fine entity obtains the value of the coarse entity of the same
+   * direction containing its lower corner. In particular, cells inherit the
+   * value of their father and copied vertices the value of their father
+   * (injection).
+   */
+  struct SPConstantProlongation
+  {
+    template< int dim, class Coarse >
+    auto operator() ( const SPMultiIndex< dim > &coarseId, const SPMultiIndex< dim > &childId,
+                      const SPMultiIndex< dim > &factor, Coarse &&coarse ) const
+    {
+      return coarse( coarseId );
+    }
+  };
+
+
+
+  // SPLinearProlongation
+  // --------------------
+
+  /**
+   * \brief multilinear prolongation
+   *
+   * Along each axis in which the entities are located on vertices, the fine
+   * values are interpolated linearly from the two adjacent coarse entities;
+   * along the remaining axes, the values are constant. Hence, vertex data is
+   * interpolated multilinearly while cell data is simply inherited.
+   *
+   * \note The value type must support multiplication by a double and
+   *       operator+=.
+   */
+  struct SPLinearProlongation
+  {
+    template< int dim, class Coarse >
+    auto operator() ( const SPMultiIndex< dim > &coarseId, const SPMultiIndex< dim > &childId,
+                      const SPMultiIndex< dim > &factor, Coarse &&coarse ) const
+    {
+      typedef std::decay_t< decltype( coarse( coarseId ) ) > Value;
+
+      // childId is zero along axes without interpolation
+      unsigned int axes = 0;
+      for( int i = 0; i < dim; ++i )
+        axes |= (childId[ i ] != 0 ? (1u << i) : 0u);
+
+      Value value = coarse( coarseId ) * weight( childId, factor, 0u, axes );
+      for( unsigned int corner = 1; corner < (1u << dim); ++corner )
+      {
+        if( (corner & ~axes) != 0 )
+          continue;
+
+        SPMultiIndex< dim > id( coarseId );
+        for( int i = 0; i < dim; ++i )
+          id[ i ] += 2*int( (corner >> i) & 1 );
+        value += coarse( id ) * weight( childId, factor, corner, axes );
+      }
+      return value;
+    }
+
+  private:
+    template< int dim >
+    static double weight ( const SPMultiIndex< dim > &childId, const SPMultiIndex< dim > &factor, unsigned int corner, unsigned int axes )
+    {
+      double weight = 1.0;
+      for( int i = 0; i < dim; ++i )
+      {
+        if( (axes >> i) & 1 )
+        {
+          const double t = double( childId[ i ] ) / double( factor[ i ] );
+          weight *= ((corner >> i) & 1 ? t : 1.0 - t);
+        }
+      }
+      return weight;
+    }
+  };
+
+
+
+  // SPLevelContainer
+  // ----------------
+
+  /**
+   * \class SPLevelContainer
+   * \brief persistent data attached to the entities of one codimension on
+   *        each grid level
+   *
+   * The data of each level is stored in a separate vector, indexed by the
+   * level index set. The container attaches itself to the grid; whenever a
+   * new level is created by global refinement, its data is computed from the
+   * data on the father level by the prolongation. This is done in one bulk
+   * loop over the index layouts of the new level, without constructing any
+   * entities.
+   *
+   * The prolongation is called as
+   * <tt>prolongation( coarseId, childId, factor, coarse )</tt>, where
+   * coarseId is the multi index of the coarse entity of the same direction
+   * containing the lower corner of the fine entity, childId holds the child
+   * position relative to it (zero along axes in which the entity is located
+   * on cells), factor is the refinement factor and coarse( id ) returns the
+   * coarse value for a multi index.
+   *
+   * \tparam  Grid          type of grid (an SPGrid)
+   * \tparam  T             value type
+   * \tparam  Prolongation  prolongation (e.g., SPConstantProlongation or
+   *                        SPLinearProlongation)
+   */
+  template< class Grid, class T, class Prolongation = SPConstantProlongation >
+  class SPLevelContainer
+    : public SPRefinementObserver< Grid >
+  {
+    typedef SPLevelContainer< Grid, T, Prolongation > This;
+    typedef SPRefinementObserver< Grid > Base;
+
+  public:
+    typedef T Value;
+
+    static const int dimension = Grid::dimension;
+
+    typedef typename Grid::GridLevel GridLevel;
+    typedef typename Grid::LevelIndexSet LevelIndexSet;
+    typedef typename LevelIndexSet::IndexType IndexType;
+    typedef typename LevelIndexSet::Layout Layout;
+    typedef typename GridLevel::MultiIndex MultiIndex;
+    typedef typename GridLevel::PartitionList PartitionList;
+
+    SPLevelContainer ( const Grid &grid, int codim, const Value &value = Value(), const Prolongation &prolongation = Prolongation() );
+
+    SPLevelContainer ( const This & ) = delete;
+    This &operator= ( const This & ) = delete;
+
+    ~SPLevelContainer () = default;
+
+    int codimension () const { return codim_; }
+
+    /** \brief data of a grid level, indexed by the level index set */
+    const std::vector< Value > &operator[] ( int level ) const { assert( level < int( data_.size() ) ); return data_[ level ]; }
+    std::vector< Value > &operator[] ( int level ) { assert( level < int( data_.size() ) ); return data_[ level ]; }
+
+    template< class Entity >
+    const Value &operator() ( const Entity &entity ) const;
+
+    template< class Entity >
+    Value &operator() ( const Entity &entity );
+
+    /** \brief number of levels stored */
+    int size () const { return data_.size(); }
+
+    void refined ( int level ) override;
+
+  private:
+    const Grid &grid () const { assert( this->observedGrid() ); return *this->observedGrid(); }
+
+    void prolong ( int level );
+
+    int codim_;
+    Value value_;
+    Prolongation prolongation_;
+    std::vector< std::vector< Value > > data_;
+  };
+
+
+
+  // Implementation of SPLevelContainer
+  // ----------------------------------
+
+  template< class Grid, class T, class Prolongation >
+  inline SPLevelContainer< Grid, T, Prolongation >
+    ::SPLevelContainer ( const Grid &grid, int codim, const Value &value, const Prolongation &prolongation )
+    : codim_( codim ), value_( value ), prolongation_( prolongation ), data_( grid.maxLevel()+1 )
+  {
+    assert( (codim >= 0) && (codim <= dimension) );
+    for( int level = 0; level <= grid.maxLevel(); ++level )
+      data_[ level ].resize( grid.levelIndexSet( level ).size( codim ), value_ );
+    grid.attach( *this );
+  }
+
+
+  template< class Grid, class T, class Prolongation >
+  template< class Entity >
+  inline const typename SPLevelContainer< Grid, T, Prolongation >::Value &
+  SPLevelContainer< Grid, T, Prolongation >::operator() ( const Entity &entity ) const
+  {
+    assert( Entity::codimension == codimension() );
+    return data_[ entity.level() ][ grid().levelIndexSet( entity.level() ).index( entity ) ];
+  }
+
+
+  template< class Grid, class T, class Prolongation >
+  template< class Entity >
+  inline typename SPLevelContainer< Grid, T, Prolongation >::Value &
+  SPLevelContainer< Grid, T, Prolongation >::operator() ( const Entity &entity )
+  {
+    assert( Entity::codimension == codimension() );
+    return data_[ entity.level() ][ grid().levelIndexSet( entity.level() ).index( entity ) ];
+  }
+
+
+  template< class Grid, class T, class Prolongation >
+  inline void SPLevelContainer< Grid, T, Prolongation >::refined ( int level )
+  {
+    assert( level > 0 );
+    data_.resize( level+1 );
+    prolong( level );
+  }
+
+
+  template< class Grid, class T, class Prolongation >
+  inline void SPLevelContainer< Grid, T, Prolongation >::prolong ( int level )
+  {
+    const GridLevel &fineLevel = grid().gridLevel( level );
+    const GridLevel &coarseLevel = grid().gridLevel( level-1 );
+    const LevelIndexSet &fineIndexSet = grid().levelIndexSet( level );
+    const LevelIndexSet &coarseIndexSet = grid().levelIndexSet( level-1 );
+
+    MultiIndex factor;
+    for( int i = 0; i < dimension; ++i )
+      factor[ i ] = fineLevel.macroFactor()[ i ] / coarseLevel.macroFactor()[ i ];
+
+    std::vector< Value > &fineData = data_[ level ];
+    const std::vector< Value > &coarseData = data_[ level-1 ];
+    fineData.assign( fineIndexSet.size( codimension() ), value_ );
+
+    // fine partitions are refined coarse partitions with the same number
+    const PartitionList &partitions = fineLevel.template partition< All_Partition >();
+    for( typename PartitionList::Iterator pit = partitions.begin(); pit; ++pit )
+    {
+      for( unsigned int dir = 0; dir < (1u << dimension); ++dir )
+      {
+        int codim = dimension;
+        for( int i = 0; i < dimension; ++i )
+          codim -= int( (dir >> i) & 1 );
+        if( codim != codimension() )
+          continue;
+
+        const Layout &fineLayout = fineIndexSet.layout( pit->number(), dir );
+        const Layout &coarseLayout = coarseIndexSet.layout( pit->number(), dir );
+        bool empty = false;
+        for( int i = 0; i < dimension; ++i )
+          empty |= (fineLayout.begin()[ i ] > fineLayout.end()[ i ]);
+        if( empty )
+          continue;
+
+        auto coarse = [ &coarseData, &coarseLayout ] ( const MultiIndex &id ) -> const Value & {
+            return coarseData[ coarseLayout.index( id ) ];
+          };
+
+        // traverse the box lexicographically, i.e., in index order
+        IndexType index = fineLayout.offset();
+        for( MultiIndex id = fineLayout.begin(); id[ dimension-1 ] <= fineLayout.end()[ dimension-1 ]; ++index )
+        {
+          MultiIndex coarseId, childId;
+          for( int i = 0; i < dimension; ++i )
+          {
+            const int k = id[ i ] >> 1;
+            coarseId[ i ] = 2*(k / factor[ i ]) + (id[ i ] & 1);
+            childId[ i ] = ((id[ i ] & 1) ? 0 : k % factor[ i ]);
+          }
+          fineData[ index ] = prolongation_( coarseId, childId, factor, coarse );
+
+          for( int i = 0; i < dimension; ++i )
+          {
+            id[ i ] += 2;
+            if( (id[ i ] <= fineLayout.end()[ i ]) || (i == dimension-1) )
+              break;
+            id[ i ] = fineLayout.begin()[ i ];
+          }
+        }
+      }
+    }
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_LEVELCONTAINER_HH
@@ -0,0 +1,281 @@
+#ifndef DUNE_SPGRID_LINEITERATOR_HH
+#define DUNE_SPGRID_LINEITERATOR_HH
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <type_traits>
+
+#include <dune/grid/common/exceptions.hh>
+
+#include <dune/grid/spgrid/direction.hh>
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/multiindex.hh>
+#include <dune/grid/spgrid/partitionlist.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  iteration over runs of entities along the first axis
+ */
+
+namespace Dune
+{
+
+  // SPLine
+  // ------
+
+  /**
+   * \class SPLine
+   * \brief run of entities along axis 0
+   *
+   * All entities of a line belong to the same partition and have the same
+   * direction. The i-th entity of the line has the index
+   * <tt>index() + i*stride()</tt> and the multi index
+   * <tt>id() + 2*i*e_0</tt>.
+   */
+  template< int dim, class Index >
+  class SPLine
+  {
+    typedef SPLine< dim, Index > This;
+
+  public:
+    static const int dimension = dim;
+
+    typedef Index IndexType;
+    typedef SPMultiIndex< dimension > MultiIndex;
+
+    SPLine () = default;
+
+    SPLine ( IndexType index, IndexType size, IndexType stride, const MultiIndex &id )
+      : index_( index ), size_( size ), stride_( stride ), id_( id )
+    {}
+
+    /** \brief index of the first entity */
+    IndexType index () const { return index_; }
+
+    /** \brief index of the i-th entity */
+    IndexType index ( IndexType i ) const { assert( i < size() ); return index_ + i*stride_; }
+
+    /** \brief number of entities in the line */
+    IndexType size () const { return size_; }
+
+    /** \brief difference of the indices of subsequent entities */
+    IndexType stride () const { return stride_; }
+
+    /** \brief multi index of the first entity */
+    const MultiIndex &id () const { return id_; }
+
+    /** \brief multi index of the i-th entity */
+    MultiIndex id ( IndexType i ) const
+    {
+      MultiIndex id( id_ );
+      id[ 0 ] += 2*int( i );
+      return id;
+    }
+
+  private:
+    IndexType index_ = 0;
+    IndexType size_ = 0;
+    IndexType stride_ = 1;
+    MultiIndex id_;
+  };
+
+
+
+  // SPLineIterator
+  // --------------
+
+  /**
+   * \class SPLineIterator
+   * \brief iterator over the lines of entities of a partition list
+   *
+   * Partitions and directions are visited in the same order as by the
+   * SPPartitionIterator. Within each box, the lines run along axis 0 and are
+   * visited lexicographically with respect to the remaining axes. Hence,
+   * flattening the lines yields exactly the (untiled) traversal order of the
+   * partition iterator with sweep direction 0.
+   *
+   * For owned-first numbering, the indices are only affine within the
+   * interior border entities and within each slab of the remaining entities,
+   * so lines are split at the boundaries of these boxes.
+   *
+   * \note The index set must use the lexicographic ordering.
+   */
+  template< int codim, class Grid >
+  class SPLineIterator
+  {
+    typedef SPLineIterator< codim, Grid > This;
+
+  public:
+    typedef SPIndexSet< Grid > IndexSet;
+
+    static const int dimension = IndexSet::dimension;
+    static const int codimension = codim;
+
+    typedef typename IndexSet::IndexType IndexType;
+    typedef typename IndexSet::GridLevel GridLevel;
+
+    typedef SPPartitionList< dimension > PartitionList;
+    typedef typename PartitionList::Partition Partition;
+    typedef typename Partition::MultiIndex MultiIndex;
+    typedef SPDirection< dimension > Direction;
+
+    typedef SPLine< dimension, IndexType > Line;
+
+    struct Begin {};
+    struct End {};
+
+  private:
+    typedef SPDirectionIterator< dimension, codimension > DirectionIterator;
+
+  public:
+    SPLineIterator () = default;
+
+    SPLineIterator ( const IndexSet &indexSet, const PartitionList &partitionList, const Begin &b );
+    SPLineIterator ( const IndexSet &indexSet, const PartitionList &partitionList, const End &e );
+
+    operator bool () const { return bool( partition_ ); }
+
+    bool operator== ( const This &other ) const { return (line_.id() == other.line_.id()); }
+    bool operator!= ( const This &other ) const { return (line_.id() != other.line_.id()); }
+
+    const Line &operator* () const { return line_; }
+    const Line *operator-> () const { return &line_; }
+
+    This &operator++ () { increment(); return *this; }
+
+  private:
+    void increment ();
+    void nextDirection ();
+    void init ();
+
+    MultiIndex begin () const;
+    void setLine ( const MultiIndex &id );
+
+    const IndexSet &indexSet () const { assert( indexSet_ ); return *indexSet_; }
+
+    const IndexSet *indexSet_ = nullptr;
+    typename PartitionList::Iterator partition_;
+    Direction direction_ = Direction( 0ul );
+    Line line_;
+  };
+
+
+
+  // Implementation of SPLineIterator
+  // --------------------------------
+
+  template< int codim, class Grid >
+  inline SPLineIterator< codim, Grid >
+    ::SPLineIterator ( const IndexSet &indexSet, const PartitionList &partitionList, const Begin &b )
+    : indexSet_( &indexSet ),
+      partition_( partitionList.begin() )
+  {
+    if( indexSet.partitionOrdering() )
+      DUNE_THROW( GridError, "Line iteration requires lexicographic ordering (got " << indexSet.ordering().name() << ")." );
+    init();
+  }
+
+
+  template< int codim, class Grid >
+  inline SPLineIterator< codim, Grid >
+    ::SPLineIterator ( const IndexSet &indexSet, const PartitionList &partitionList, const End &e )
+    : indexSet_( &indexSet ),
+      partition_( partitionList.end() )
+  {
+    init();
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPLineIterator< codim, Grid >::increment ()
+  {
+    MultiIndex id = line_.id();
+    id[ 0 ] += 2*int( line_.size() );
+    if( id[ 0 ] <= partition_->bound( 1, 0, direction_[ 0 ] ) )
+      return setLine( id );
+    id[ 0 ] = partition_->bound( 0, 0, direction_[ 0 ] );
+
+    for( int i = 1; i < dimension; ++i )
+    {
+      id[ i ] += 2;
+      if( id[ i ] <= partition_->bound( 1, i, direction_[ i ] ) )
+        return setLine( id );
+      id[ i ] = partition_->bound( 0, i, direction_[ i ] );
+    }
+
+    nextDirection();
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPLineIterator< codim, Grid >::nextDirection ()
+  {
+    DirectionIterator dirIt( direction_ );
+    ++dirIt;
+    for( ; dirIt && partition_->empty( *dirIt ); ++dirIt )
+      continue;
+    if( dirIt )
+    {
+      direction_ = *dirIt;
+      setLine( begin() );
+    }
+    else
+    {
+      ++partition_;
+      init();
+    }
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPLineIterator< codim, Grid >::init ()
+  {
+    if( partition_ )
+    {
+      DirectionIterator dirIt;
+      for( ; dirIt && partition_->empty( *dirIt ); ++dirIt )
+        continue;
+      if( dirIt )
+      {
+        direction_ = *dirIt;
+        setLine( begin() );
+      }
+      else
+      {
+        ++partition_;
+        init();
+      }
+    }
+    else
+    {
+      MultiIndex id;
+      std::fill( id.begin(), id.end(), std::numeric_limits< int >::max() );
+      line_ = Line( 0, 0, 1, id );
+    }
+  }
+
+
+  template< int codim, class Grid >
+  inline typename SPLineIterator< codim, Grid >::MultiIndex
+  SPLineIterator< codim, Grid >::begin () const
+  {
+    MultiIndex id;
+    for( int i = 0; i < dimension; ++i )
+      id[ i ] = partition_->bound( 0, i, direction_[ i ] );
+    return id;
+  }
+
+
+  template< int codim, class Grid >
+  inline void SPLineIterator< codim, Grid >::setLine ( const MultiIndex &id )
+  {
+    // lexicographic numbering within each box: axis 0 runs fastest
+    const typename IndexSet::Layout &layout = indexSet().box( id, partition_->number(), direction_.bits() );
+    const IndexType size = ((std::min( partition_->bound( 1, 0, direction_[ 0 ] ), layout.end()[ 0 ] ) - id[ 0 ]) >> 1) + 1;
+    line_ = Line( layout.index( id ), size, layout.stride( 0 ), id );
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_LINEITERATOR_HH
@@ -1,6 +1,8 @@
 #ifndef DUNE_SPGRID_MESH_HH
 #define DUNE_SPGRID_MESH_HH
 
+#include <cstddef>
+
 #include <array>
 #include <type_traits>
 
@@ -53,7 +55,7 @@ namespace Dune
 
     std::pair< This, This > split ( const int dir, const int leftWeight, const int rightWeight ) const;
 
-    int volume () const;
+    std::size_t volume () const;
 
     MultiIndex width () const;
     int width ( const int i ) const;
@@ -180,12 +182,12 @@ namespace Dune
 
 
   template< int dim >
-  inline int SPMesh< dim >::volume () const
+  inline std::size_t SPMesh< dim >::volume () const
   {
     const MultiIndex &w = width();
-    int volume = 1;
+    std::size_t volume = 1;
     for( int i = 0; i < dimension; ++i )
-      volume *= w[ i ];
+      volume *= std::size_t( w[ i ] );
     return volume;
   }
 
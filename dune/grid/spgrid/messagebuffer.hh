@@ -5,6 +5,9 @@
 #include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <algorithm>
+#include <map>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -15,6 +18,154 @@
 namespace Dune
 {
 
+  // SPMessageBufferPool
+  // -------------------
+
+  /**
+   * \brief pool of message buffer storage, keyed by neighbor rank
+   *
+   * Packed message buffers constructed with a pool take their storage from
+   * it and return it on destruction, keeping its capacity. If presizing is
+   * enabled, newly allocated storage is sized by the last message exchanged
+   * with the same rank. Hence, repeated halo exchanges of the same shape do
+   * not allocate any memory in the steady state.
+   *
+   * For each rank and kind, the pool keeps at most maxFree buffers; storage
+   * returned beyond this limit is freed. A single exchange uses one buffer of
+   * each kind per rank, so the default limit covers two exchanges in flight
+   * without retaining the peak of many concurrent communications.
+   *
+   * \note The pool is thread-safe, so that communications can be set up
+   *       concurrently.
+   */
+  class SPMessageBufferPool
+  {
+    typedef SPMessageBufferPool This;
+
+  public:
+    enum Kind { sendBuffer = 0, receiveBuffer = 1 };
+
+    struct Storage
+    {
+      void *data = nullptr;
+      std::size_t capacity = 0;
+    };
+
+    explicit SPMessageBufferPool ( bool presize = true, std::size_t maxFree = 2 )
+      : presize_( presize ), maxFree_( maxFree )
+    {}
+
+    SPMessageBufferPool ( const This & ) = delete;
+
+    ~SPMessageBufferPool () { clear(); }
+
+    This &operator= ( const This & ) = delete;
+
+    /** \brief obtain storage of at least the given capacity */
+    Storage acquire ( int rank, Kind kind, std::size_t capacity = 0 )
+    {
+      Storage storage;
+      {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        Entry &entry = entries_[ std::make_pair( rank, int( kind ) ) ];
+        if( !entry.free.empty() )
+        {
+          storage = entry.free.back();
+          entry.free.pop_back();
+        }
+        if( presize_ )
+          capacity = std::max( capacity, entry.lastSize );
+      }
+      reserve( storage, capacity );
+      return storage;
+    }
+
+    /** \brief return storage to the pool, recording the size of the last message */
+    void release ( int rank, Kind kind, const Storage &storage, std::size_t size )
+    {
+      {
+        std::lock_guard< std::mutex > lock( mutex_ );
+        Entry &entry = entries_[ std::make_pair( rank, int( kind ) ) ];
+        entry.lastSize = size;
+        if( !storage.data || (entry.free.size() < maxFree_) )
+        {
+          if( storage.data )
+            entry.free.push_back( storage );
+          return;
+        }
+      }
+      std::free( storage.data );
+    }
+
+    /** \brief free all pooled storage */
+    void clear ()
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      for( auto &entry : entries_ )
+      {
+        for( const Storage &storage : entry.second.free )
+          std::free( storage.data );
+      }
+      entries_.clear();
+    }
+
+    bool presize () const { return presize_; }
+    void setPresize ( bool presize ) { presize_ = presize; }
+
+    /** \brief maximum number of buffers kept per rank and kind */
+    std::size_t maxFree () const { return maxFree_; }
+    void setMaxFree ( std::size_t maxFree ) { maxFree_ = maxFree; }
+
+    /** \brief total capacity currently held by the pool */
+    std::size_t capacity () const
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      std::size_t capacity = 0;
+      for( const auto &entry : entries_ )
+      {
+        for( const Storage &storage : entry.second.free )
+          capacity += storage.capacity;
+      }
+      return capacity;
+    }
+
+    /** \brief number of buffers currently held by the pool */
+    std::size_t size () const
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      std::size_t size = 0;
+      for( const auto &entry : entries_ )
+        size += entry.second.free.size();
+      return size;
+    }
+
+    static void reserve ( Storage &storage, std::size_t capacity )
+    {
+      if( capacity <= storage.capacity )
+        return;
+
+      void *data = std::realloc( storage.data, capacity );
+      if( !data )
+        DUNE_THROW( OutOfMemoryError, "Cannot allocate sufficiently large buffer." );
+      storage.data = data;
+      storage.capacity = capacity;
+    }
+
+  private:
+    struct Entry
+    {
+      std::vector< Storage > free;
+      std::size_t lastSize = 0;
+    };
+
+    std::map< std::pair< int, int >, Entry > entries_;
+    bool presize_;
+    std::size_t maxFree_;
+    mutable std::mutex mutex_;
+  };
+
+
+
   // SPBasicPackedMessageWriteBuffer
   // -------------------------------
 
@@ -25,24 +176,37 @@ namespace Dune
   public:
     SPBasicPackedMessageWriteBuffer () { initialize(); }
 
+    SPBasicPackedMessageWriteBuffer ( SPMessageBufferPool &pool, int rank )
+      : pool_( &pool ), poolRank_( rank )
+    {
+      const SPMessageBufferPool::Storage storage = pool.acquire( rank, SPMessageBufferPool::sendBuffer );
+      buffer_ = storage.data;
+      position_ = 0;
+      capacity_ = storage.capacity;
+    }
+
     SPBasicPackedMessageWriteBuffer ( const This & ) = delete;
 
     SPBasicPackedMessageWriteBuffer ( This &&other )
       : buffer_( other.buffer_ ),
-        position_( other.position_ ), capacity_( other.capacity_ )
+        position_( other.position_ ), capacity_( other.capacity_ ),
+        pool_( other.pool_ ), poolRank_( other.poolRank_ )
     {
       other.initialize();
     }
 
-    ~SPBasicPackedMessageWriteBuffer () { std::free( buffer_ ); }
+    ~SPBasicPackedMessageWriteBuffer () { release(); }
 
     This &operator= ( const This & ) = delete;
 
     This &operator= ( This &&other )
     {
+      release();
       buffer_ = other.buffer_;
       position_ = other.position_;
       capacity_ = other.capacity_;
+      pool_ = other.pool_;
+      poolRank_ = other.poolRank_;
       other.initialize();
       return *this;
     }
@@ -55,10 +219,28 @@ namespace Dune
       position_ += sizeof( T );
     }
 
+    /** \brief write n consecutive values */
+    template< class T >
+    void write ( const T *values, std::size_t n )
+    {
+      reserve( position_ + n*sizeof( T ) );
+      std::memcpy( static_cast< char * >( buffer_ ) + position_, values, n*sizeof( T ) );
+      position_ += n*sizeof( T );
+    }
+
     std::size_t position () const { return position_; }
 
   protected:
-    void initialize () { buffer_ = nullptr; position_ = 0; capacity_ = 0; }
+    void initialize () { buffer_ = nullptr; position_ = 0; capacity_ = 0; pool_ = nullptr; poolRank_ = 0; }
+
+    void release ()
+    {
+      if( pool_ )
+        pool_->release( poolRank_, SPMessageBufferPool::sendBuffer, SPMessageBufferPool::Storage{ buffer_, capacity_ }, position_ );
+      else
+        std::free( buffer_ );
+      initialize();
+    }
 
     void reserve ( std::size_t size )
     {
@@ -80,6 +262,8 @@ namespace Dune
 
     void *buffer_;
     std::size_t position_, capacity_;
+    SPMessageBufferPool *pool_ = nullptr;
+    int poolRank_ = 0;
   };
 
 
@@ -99,9 +283,11 @@ namespace Dune
 
   public:
     explicit SPPackedMessageWriteBuffer ( const Communication< C > &comm ) {}
+    SPPackedMessageWriteBuffer ( const Communication< C > &comm, SPMessageBufferPool &pool, int rank ) : Base( pool, rank ) {}
 
     void send ( int rank, int tag ) {}
     void wait () {}
+    bool test () { return true; }
   };
 
 #if HAVE_MPI
@@ -115,6 +301,10 @@ namespace Dune
   public:
     explicit SPPackedMessageWriteBuffer ( const Communication< MPI_Comm > &comm ) : comm_( comm ) {}
 
+    SPPackedMessageWriteBuffer ( const Communication< MPI_Comm > &comm, SPMessageBufferPool &pool, int rank )
+      : Base( pool, rank ), comm_( comm )
+    {}
+
     void send ( int rank, int tag )
     {
       MPI_Isend( buffer_, position_, MPI_PACKED, rank, tag, comm_, &request_ );
@@ -122,6 +312,13 @@ namespace Dune
 
     void wait () { MPI_Wait( &request_, MPI_STATUS_IGNORE ); }
 
+    bool test ()
+    {
+      int flag = 0;
+      MPI_Test( &request_, &flag, MPI_STATUS_IGNORE );
+      return bool( flag );
+    }
+
   protected:
     MPI_Comm comm_;
     MPI_Request request_;
@@ -140,24 +337,31 @@ namespace Dune
   public:
     SPBasicPackedMessageReadBuffer () { initialize(); }
 
+    explicit SPBasicPackedMessageReadBuffer ( SPMessageBufferPool &pool ) { initialize(); pool_ = &pool; }
+
     SPBasicPackedMessageReadBuffer ( const This & ) = delete;
 
     SPBasicPackedMessageReadBuffer ( This &&other )
       : buffer_( other.buffer_ ),
-        position_( other.position_ ), size_( other.size_ )
+        position_( other.position_ ), size_( other.size_ ), capacity_( other.capacity_ ),
+        pool_( other.pool_ ), poolRank_( other.poolRank_ )
     {
       other.initialize();
     }
 
-    ~SPBasicPackedMessageReadBuffer () { std::free( buffer_ ); }
+    ~SPBasicPackedMessageReadBuffer () { release(); }
 
     This &operator= ( const This & ) = delete;
 
     This &operator= ( This &&other )
     {
+      release();
       buffer_ = other.buffer_;
       position_ = other.position_;
       size_ = other.size_;
+      capacity_ = other.capacity_;
+      pool_ = other.pool_;
+      poolRank_ = other.poolRank_;
       other.initialize();
       return *this;
     }
@@ -174,25 +378,60 @@ namespace Dune
         DUNE_THROW( IOError, "Cannot read beyond the buffer's end." );
     }
 
+    /** \brief read n consecutive values */
+    template< class T >
+    void read ( T *values, std::size_t n )
+    {
+      if( position_ + n*sizeof( T ) <= size_ )
+      {
+        std::memcpy( static_cast< void * >( values ), static_cast< char * >( buffer_ ) + position_, n*sizeof( T ) );
+        position_ += n*sizeof( T );
+      }
+      else
+        DUNE_THROW( IOError, "Cannot read beyond the buffer's end." );
+    }
+
     std::size_t position () const { return position_; }
 
   protected:
-    void initialize () { buffer_ = nullptr; position_ = 0; size_ = 0; }
+    void initialize () { buffer_ = nullptr; position_ = 0; size_ = 0; capacity_ = 0; pool_ = nullptr; poolRank_ = 0; }
 
-    void reset ( std::size_t size )
+    void release ()
     {
-      std::free( buffer_ );
+      SPMessageBufferPool *pool = pool_;
+      if( pool && buffer_ )
+        pool->release( poolRank_, SPMessageBufferPool::receiveBuffer, SPMessageBufferPool::Storage{ buffer_, capacity_ }, size_ );
+      else
+        std::free( buffer_ );
       initialize();
+      pool_ = pool;
+    }
+
+    void reset ( int rank, std::size_t size )
+    {
+      release();
+      if( pool_ )
+      {
+        poolRank_ = rank;
+        const SPMessageBufferPool::Storage storage = pool_->acquire( rank, SPMessageBufferPool::receiveBuffer, size );
+        buffer_ = storage.data;
+        capacity_ = storage.capacity;
+        size_ = size;
+        return;
+      }
+
       if( size == 0 )
         return;
       buffer_ = std::malloc( size );
       if( !buffer_ )
         DUNE_THROW( OutOfMemoryError, "Cannot allocate sufficiently large buffer." );
-      size_ = size;
+      size_ = capacity_ = size;
     }
 
     void *buffer_;
-    std::size_t position_, size_;
+    std::size_t position_, size_, capacity_;
+    SPMessageBufferPool *pool_ = nullptr;
+    int poolRank_ = 0;
   };
 
 
@@ -212,6 +451,7 @@ namespace Dune
 
   public:
     explicit SPPackedMessageReadBuffer ( const Communication< C > &comm ) {}
+    SPPackedMessageReadBuffer ( const Communication< C > &comm, SPMessageBufferPool &pool ) : Base( pool ) {}
 
     void receive ( int rank, int rag, std::size_t size )
     {
@@ -221,6 +461,8 @@ namespace Dune
     void receive ( int rank, int tag ) { receive( rank, tag, 0 ); }
     void receive ( int tag ) { receive( 0, tag, 0 ); }
 
+    bool tryReceive ( int tag ) { return false; }
+
     int rank () const { return 0 ; }
 
     void wait () {}
@@ -229,6 +471,11 @@ namespace Dune
     {
       return readBuffers.end();
     }
+
+    friend inline std::vector< std::size_t > testSome ( std::vector< This > &readBuffers )
+    {
+      return std::vector< std::size_t >();
+    }
   };
 
 #if HAVE_MPI
@@ -241,11 +488,12 @@ namespace Dune
 
   public:
     SPPackedMessageReadBuffer ( const Communication< MPI_Comm > &comm ) : comm_( comm ) {}
+    SPPackedMessageReadBuffer ( const Communication< MPI_Comm > &comm, SPMessageBufferPool &pool ) : Base( pool ), comm_( comm ) {}
 
     void receive ( int rank, int tag, std::size_t size )
     {
       rank_ = rank;
-      reset( size );
+      reset( rank, size );
       MPI_Irecv( buffer_, size_, MPI_BYTE, rank, tag, comm_, &request_ );
     }
 
@@ -260,6 +508,20 @@ namespace Dune
 
     void receive ( int tag ) { receive( MPI_ANY_SOURCE, tag ); }
 
+    /** \brief receive a message from any source, if one has already arrived */
+    bool tryReceive ( int tag )
+    {
+      int flag = 0;
+      MPI_Status status;
+      MPI_Iprobe( MPI_ANY_SOURCE, tag, comm_, &flag, &status );
+      if( !flag )
+        return false;
+      int count;
+      MPI_Get_count( &status, MPI_BYTE, &count );
+      receive( status.MPI_SOURCE, tag, count );
+      return true;
+    }
+
     int rank () const { return rank_; }
 
     void wait () { MPI_Wait( &request_, MPI_STATUS_IGNORE ); }
@@ -280,6 +542,25 @@ namespace Dune
       return readBuffers.begin() + index;
     }
 
+    /** \brief indices of all buffers whose message has arrived since the last call */
+    friend inline std::vector< std::size_t > testSome ( std::vector< This > &readBuffers )
+    {
+      const std::size_t numBuffers = readBuffers.size();
+      std::vector< MPI_Request > requests( numBuffers );
+      for( std::size_t i = 0; i < numBuffers; ++i )
+        requests[ i ] = readBuffers[ i ].request_;
+
+      int count = MPI_UNDEFINED;
+      std::vector< int > indices( numBuffers );
+      MPI_Testsome( numBuffers, requests.data(), &count, indices.data(), MPI_STATUSES_IGNORE );
+      for( std::size_t i = 0; i < numBuffers; ++i )
+        readBuffers[ i ].request_ = requests[ i ];
+
+      if( count == MPI_UNDEFINED )
+        return std::vector< std::size_t >();
+      return std::vector< std::size_t >( indices.begin(), indices.begin() + count );
+    }
+
   protected:
     int rank_;
     MPI_Comm comm_;
@@ -287,6 +568,198 @@ namespace Dune
   };
 #endif // #if HAVE_MPI
 
+
+
+  // SPBasicPersistentMessageBuffer
+  // ------------------------------
+
+  /**
+   * \brief message buffer of fixed size for persistent communication
+   *
+   * The storage is allocated once on construction and never moves, so that
+   * persistent requests may refer to it. Before each message, the buffer is
+   * rewound.
+   */
+  class SPBasicPersistentMessageBuffer
+  {
+    typedef SPBasicPersistentMessageBuffer This;
+
+  public:
+    explicit SPBasicPersistentMessageBuffer ( std::size_t size ) : buffer_( size ), position_( 0 ) {}
+
+    SPBasicPersistentMessageBuffer ( const This & ) = delete;
+    SPBasicPersistentMessageBuffer ( This && ) = default;
+
+    This &operator= ( const This & ) = delete;
+    This &operator= ( This && ) = default;
+
+    template< class T >
+    void write ( const T &value )
+    {
+      if( position_ + sizeof( T ) <= size() )
+      {
+        std::memcpy( buffer_.data() + position_, &value, sizeof( T ) );
+        position_ += sizeof( T );
+      }
+      else
+        DUNE_THROW( IOError, "Cannot write beyond the buffer's end." );
+    }
+
+    template< class T >
+    void read ( T &value )
+    {
+      if( position_ + sizeof( T ) <= size() )
+      {
+        std::memcpy( static_cast< void * >( &value ), buffer_.data() + position_, sizeof( T ) );
+        position_ += sizeof( T );
+      }
+      else
+        DUNE_THROW( IOError, "Cannot read beyond the buffer's end." );
+    }
+
+    /** \brief write n consecutive values */
+    template< class T >
+    void write ( const T *values, std::size_t n )
+    {
+      if( position_ + n*sizeof( T ) <= size() )
+      {
+        std::memcpy( buffer_.data() + position_, values, n*sizeof( T ) );
+        position_ += n*sizeof( T );
+      }
+      else
+        DUNE_THROW( IOError, "Cannot write beyond the buffer's end." );
+    }
+
+    /** \brief read n consecutive values */
+    template< class T >
+    void read ( T *values, std::size_t n )
+    {
+      if( position_ + n*sizeof( T ) <= size() )
+      {
+        std::memcpy( static_cast< void * >( values ), buffer_.data() + position_, n*sizeof( T ) );
+        position_ += n*sizeof( T );
+      }
+      else
+        DUNE_THROW( IOError, "Cannot read beyond the buffer's end." );
+    }
+
+    std::size_t position () const { return position_; }
+    std::size_t size () const { return buffer_.size(); }
+
+    char *data () { return buffer_.data(); }
+    const char *data () const { return buffer_.data(); }
+
+    void rewind () { position_ = 0; }
+
+  protected:
+    std::vector< char > buffer_;
+    std::size_t position_;
+  };
+
+
+
+  // SPPersistentMessageBuffer
+  // -------------------------
+
+  template< class Communication >
+  class SPPersistentMessageBuffer;
+
+  template< class C >
+  class SPPersistentMessageBuffer< Communication< C > >
+    : public SPBasicPersistentMessageBuffer
+  {
+    typedef SPPersistentMessageBuffer< Communication< C > > This;
+    typedef SPBasicPersistentMessageBuffer Base;
+
+  public:
+    SPPersistentMessageBuffer ( const Communication< C > &comm, std::size_t size ) : Base( size ) {}
+
+    void initSend ( int rank, int tag ) {}
+
+    void initReceive ( int rank, int tag )
+    {
+      DUNE_THROW( IOError, "Nothing to receive in a serial communication." );
+    }
+
+    int rank () const { return 0; }
+
+    void start () { rewind(); }
+    void wait () { rewind(); }
+
+    friend inline typename std::vector< This >::iterator waitAny ( std::vector< This > &buffers )
+    {
+      return buffers.end();
+    }
+  };
+
+#if HAVE_MPI
+  template<>
+  class SPPersistentMessageBuffer< Communication< MPI_Comm > >
+    : public SPBasicPersistentMessageBuffer
+  {
+    typedef SPPersistentMessageBuffer< Communication< MPI_Comm > > This;
+    typedef SPBasicPersistentMessageBuffer Base;
+
+  public:
+    SPPersistentMessageBuffer ( const Communication< MPI_Comm > &comm, std::size_t size )
+      : Base( size ), comm_( comm ), rank_( MPI_PROC_NULL ), request_( MPI_REQUEST_NULL )
+    {}
+
+    SPPersistentMessageBuffer ( This &&other )
+      : Base( std::move( other ) ), comm_( other.comm_ ), rank_( other.rank_ ), request_( other.request_ )
+    {
+      other.request_ = MPI_REQUEST_NULL;
+    }
+
+    ~SPPersistentMessageBuffer ()
+    {
+      if( request_ != MPI_REQUEST_NULL )
+        MPI_Request_free( &request_ );
+    }
+
+    void initSend ( int rank, int tag )
+    {
+      assert( request_ == MPI_REQUEST_NULL );
+      rank_ = rank;
+      MPI_Send_init( buffer_.data(), int( size() ), MPI_BYTE, rank, tag, comm_, &request_ );
+    }
+
+    void initReceive ( int rank, int tag )
+    {
+      assert( request_ == MPI_REQUEST_NULL );
+      rank_ = rank;
+      MPI_Recv_init( buffer_.data(), int( size() ), MPI_BYTE, rank, tag, comm_, &request_ );
+    }
+
+    int rank () const { return rank_; }
+
+    void start () { rewind(); MPI_Start( &request_ ); }
+    void wait () { MPI_Wait( &request_, MPI_STATUS_IGNORE ); rewind(); }
+
+    friend inline typename std::vector< This >::iterator waitAny ( std::vector< This > &buffers )
+    {
+      const std::size_t numBuffers = buffers.size();
+      std::vector< MPI_Request > requests( numBuffers );
+      for( std::size_t i = 0; i < numBuffers; ++i )
+        requests[ i ] = buffers[ i ].request_;
+
+      // completed persistent requests become inactive, but keep their handle
+      int index = MPI_UNDEFINED;
+      MPI_Waitany( numBuffers, requests.data(), &index, MPI_STATUS_IGNORE );
+      if( index == MPI_UNDEFINED )
+        return buffers.end();
+
+      buffers[ index ].rewind();
+      return buffers.begin() + index;
+    }
+
+  protected:
+    MPI_Comm comm_;
+    int rank_;
+    MPI_Request request_;
+  };
+#endif // #if HAVE_MPI
+
 } // namespace Dune
 
 #endif // #ifndef DUNE_GRID_SPGRID_MESSAGEBUFFER_HH
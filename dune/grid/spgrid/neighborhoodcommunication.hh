@@ -0,0 +1,221 @@
+#ifndef DUNE_SPGRID_NEIGHBORHOODCOMMUNICATION_HH
+#define DUNE_SPGRID_NEIGHBORHOODCOMMUNICATION_HH
+
+#include <cassert>
+#include <cstddef>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
+#include <dune/grid/spgrid/vectorcommunication.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  communication of vectors indexed by an SPIndexSet using
+ *          neighborhood collectives
+ */
+
+namespace Dune
+{
+
+  // SPNeighborhoodCommunication
+  // ---------------------------
+
+  /**
+   * \class SPNeighborhoodCommunication
+   * \brief communication of a vector indexed by an SPIndexSet using
+   *        neighborhood collectives
+   *
+   * On construction, the neighbor ranks of the communication interface are
+   * turned into a distributed graph topology. Each exchange then packs the
+   * send lists line by line into one contiguous buffer and transfers all
+   * messages by a single MPI_Ineighbor_alltoallv instead of one send and one
+   * receive per link:
+   * \code
+   * SPNeighborhoodCommunication< Grid, double > communication( gridView.indexSet(), codim, iftype, dir );
+   * communication.start( data );
+   * // compute something else
+   * communication.wait();
+   * \endcode
+   *
+   * \note Construction is collective on the grid's communicator. Exchanges
+   *       must be started in the same order on all processes. The vector
+   *       must not be reallocated while a communication is in progress.
+   *
+   * \note The message size per neighbor must fit into an int, as required by
+   *       MPI_Ineighbor_alltoallv. Larger messages raise a RangeError on
+   *       construction; use SPVectorCommunication for them.
+   */
+  template< class Grid, class T, class Comm = typename Grid::Communication >
+  class SPNeighborhoodCommunication
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPNeighborhoodCommunication< Grid, T, Comm > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+
+    SPNeighborhoodCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 )
+      : Base( indexSet, codim, iftype, dir, blockSize )
+    {
+      assert( this->interface_.size() == 0u );
+    }
+
+    void start ( std::vector< T > &data ) { this->checkSize( data ); }
+    void wait () {}
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return true; }
+  };
+
+#if HAVE_MPI
+  template< class Grid, class T >
+  class SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > >
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+    typedef typename Base::Interface Interface;
+
+    SPNeighborhoodCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 );
+
+    SPNeighborhoodCommunication ( const This & ) = delete;
+
+    ~SPNeighborhoodCommunication ();
+
+    This &operator= ( const This & ) = delete;
+
+    void start ( std::vector< T > &data );
+    void wait ();
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return !data_; }
+
+  private:
+    MPI_Comm graphComm_;
+    std::vector< int > sendCounts_, sendDisplacements_;
+    std::vector< int > receiveCounts_, receiveDisplacements_;
+    SPBasicPersistentMessageBuffer sendBuffer_, receiveBuffer_;
+    MPI_Request request_;
+    std::vector< T > *data_ = nullptr;
+  };
+#endif // #if HAVE_MPI
+
+
+
+#if HAVE_MPI
+  // Implementation of SPNeighborhoodCommunication
+  // ---------------------------------------------
+
+  template< class Grid, class T >
+  inline SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > >
+    ::SPNeighborhoodCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize )
+    : Base( indexSet, codim, iftype, dir, blockSize ),
+      sendBuffer_( 0 ),
+      receiveBuffer_( 0 )
+  {
+    // MPI_Ineighbor_alltoallv takes counts and displacements as int
+    std::size_t maxSize = 0;
+    auto toInt = [ &maxSize ] ( std::size_t size ) {
+        maxSize = std::max( maxSize, size );
+        return int( std::min( size, std::size_t( std::numeric_limits< int >::max() ) ) );
+      };
+
+    // SPLinkage adds at most one link per remote rank (periodic copies are
+    // merged into its partition lists), so the graph has no multi-edges
+    std::vector< int > ranks;
+    std::size_t sendSize = 0, receiveSize = 0;
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      assert( ranks.empty() || (ranks.back() < it->rank()) );
+      ranks.push_back( it->rank() );
+
+      const std::size_t sendCount = this->messageSize( it->sendList( dir ) );
+      sendDisplacements_.push_back( toInt( sendSize ) );
+      sendCounts_.push_back( toInt( sendCount ) );
+      sendSize += sendCount;
+
+      const std::size_t receiveCount = this->messageSize( it->receiveList( dir ) );
+      receiveDisplacements_.push_back( toInt( receiveSize ) );
+      receiveCounts_.push_back( toInt( receiveCount ) );
+      receiveSize += receiveCount;
+    }
+
+    // construction is collective, so all processes must fail together
+    const int overflow = (maxSize > std::size_t( std::numeric_limits< int >::max() ));
+    if( indexSet.gridLevel().grid().comm().max( overflow ) )
+      DUNE_THROW( RangeError, "Neighborhood communication message too large (size: " << maxSize << " bytes)." );
+
+    sendBuffer_ = SPBasicPersistentMessageBuffer( sendSize );
+    receiveBuffer_ = SPBasicPersistentMessageBuffer( receiveSize );
+
+    // links are symmetric, so the neighbors are both sources and destinations
+    const MPI_Comm comm = indexSet.gridLevel().grid().messageComm();
+    MPI_Dist_graph_create_adjacent( comm, int( ranks.size() ), ranks.data(), MPI_UNWEIGHTED, int( ranks.size() ), ranks.data(), MPI_UNWEIGHTED,
+                                    MPI_INFO_NULL, 0, &graphComm_ );
+  }
+
+
+  template< class Grid, class T >
+  inline SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > >::~SPNeighborhoodCommunication ()
+  {
+    wait();
+    MPI_Comm_free( &graphComm_ );
+  }
+
+
+  template< class Grid, class T >
+  inline void SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > >::start ( std::vector< T > &data )
+  {
+    if( !ready() )
+      DUNE_THROW( InvalidStateException, "Neighborhood communication is already in progress." );
+    this->checkSize( data );
+
+    sendBuffer_.rewind();
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+      __SPGrid::packLines( this->indexSet(), it->sendList( this->dir_ ), this->codimension(), data.data(), this->blockSize(), sendBuffer_ );
+    assert( sendBuffer_.position() == sendBuffer_.size() );
+
+    MPI_Ineighbor_alltoallv( sendBuffer_.data(), sendCounts_.data(), sendDisplacements_.data(), MPI_BYTE,
+                             receiveBuffer_.data(), receiveCounts_.data(), receiveDisplacements_.data(), MPI_BYTE,
+                             graphComm_, &request_ );
+    data_ = &data;
+  }
+
+
+  template< class Grid, class T >
+  inline void SPNeighborhoodCommunication< Grid, T, Communication< MPI_Comm > >::wait ()
+  {
+    if( ready() )
+      return;
+
+    MPI_Wait( &request_, MPI_STATUS_IGNORE );
+
+    receiveBuffer_.rewind();
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+      __SPGrid::unpackLines( this->indexSet(), it->receiveList( this->dir_ ), this->codimension(), data_->data(), this->blockSize(), receiveBuffer_ );
+    assert( receiveBuffer_.position() == receiveBuffer_.size() );
+
+    data_ = nullptr;
+  }
+#endif // #if HAVE_MPI
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_NEIGHBORHOODCOMMUNICATION_HH
@@ -0,0 +1,353 @@
+#ifndef DUNE_SPGRID_ORDERING_HH
+#define DUNE_SPGRID_ORDERING_HH
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <dune/grid/common/exceptions.hh>
+
+#include <dune/grid/spgrid/cachedpartitionlist.hh>
+#include <dune/grid/spgrid/multiindex.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  traversal and numbering orders for partition boxes
+ */
+
+namespace Dune
+{
+
+  // SPOrdering
+  // ----------
+
+  /**
+   * \class SPOrdering
+   * \brief order in which the entities of a partition box are traversed and
+   *        numbered
+   *
+   * Apart from the lexicographic order, the entities of each partition box
+   * (and each direction) can be arranged along a space-filling curve. The
+   * curve is laid over the box of local coordinates, i.e., it starts in the
+   * lower left corner of each partition.
+   *
+   * \tparam  dim  dimension of the grid
+   */
+  template< int dim >
+  class SPOrdering
+  {
+    typedef SPOrdering< dim > This;
+
+  public:
+    static const int dimension = dim;
+
+    typedef SPMultiIndex< dimension > MultiIndex;
+
+    typedef std::uint64_t Key;
+
+    enum Type { lexicographic, morton, hilbert };
+
+    explicit SPOrdering ( Type type = lexicographic ) : type_( type ) {}
+
+    Type type () const { return type_; }
+
+    bool isLexicographic () const { return (type_ == lexicographic); }
+
+    std::string name () const;
+
+    /**
+     * \brief compute sort key of a local coordinate
+     *
+     * \param[in]  x     local coordinate (all components in [0, 2^bits[)
+     * \param[in]  bits  number of bits per component
+     */
+    Key key ( const MultiIndex &x, int bits ) const;
+
+    /**
+     * \brief compute traversal order of a box
+     *
+     * \param[in]  width  number of entities in each direction
+     *
+     * \returns lexicographic local indices in traversal order
+     */
+    template< class Index >
+    std::vector< Index > order ( const MultiIndex &width ) const;
+
+  private:
+    static Key mortonKey ( const MultiIndex &x, int bits );
+    static Key hilbertKey ( const MultiIndex &x, int bits );
+
+    Type type_;
+  };
+
+
+
+  // SPPartitionOrdering
+  // -------------------
+
+  /**
+   * \class SPPartitionOrdering
+   * \brief traversal order of all entities in a partition list
+   *
+   * For each partition and each direction, a permutation of the lexicographic
+   * local indices is stored together with its inverse.
+   *
+   * \tparam  dim    dimension of the partitions
+   * \tparam  Index  type of the local indices
+   */
+  template< int dim, class Index = unsigned int >
+  class SPPartitionOrdering
+  {
+    typedef SPPartitionOrdering< dim, Index > This;
+
+  public:
+    static const int dimension = dim;
+
+    typedef SPOrdering< dimension > Ordering;
+    typedef SPCachedPartitionList< dimension > PartitionList;
+
+    typedef typename PartitionList::Partition Partition;
+    typedef typename PartitionList::MultiIndex MultiIndex;
+
+    static const unsigned int numDirections = (1u << dimension);
+
+    SPPartitionOrdering ( const Ordering &ordering, const PartitionList &partitions );
+
+    const Ordering &ordering () const { return ordering_; }
+    const PartitionList &partitions () const { return partitions_; }
+
+    /** \brief number of entities with given direction in a partition */
+    Index size ( unsigned int number, unsigned int dir ) const { return table( number, dir ).order.size(); }
+
+    /** \brief position of an entity in traversal order, given its lexicographic local index */
+    Index rank ( unsigned int number, unsigned int dir, Index index ) const
+    {
+      assert( index < size( number, dir ) );
+      return table( number, dir ).rank[ index ];
+    }
+
+    /** \brief multi index of the entity at given position in traversal order */
+    MultiIndex id ( unsigned int number, unsigned int dir, Index position ) const;
+
+  private:
+    struct Table
+    {
+      std::vector< Index > order, rank;
+    };
+
+    const Table &table ( unsigned int number, unsigned int dir ) const
+    {
+      assert( dir < numDirections );
+      return tables_[ number - partitions().minNumber() ][ dir ];
+    }
+
+    Ordering ordering_;
+    const PartitionList &partitions_;
+    std::vector< std::array< Table, numDirections > > tables_;
+  };
+
+
+
+  // Implementation of SPOrdering
+  // ----------------------------
+
+  template< int dim >
+  inline std::string SPOrdering< dim >::name () const
+  {
+    switch( type() )
+    {
+    case lexicographic:
+      return "lexicographic";
+    case morton:
+      return "morton";
+    case hilbert:
+      return "hilbert";
+    default:
+      DUNE_THROW( GridError, "Invalid ordering type." );
+    }
+  }
+
+
+  template< int dim >
+  inline typename SPOrdering< dim >::Key
+  SPOrdering< dim >::key ( const MultiIndex &x, int bits ) const
+  {
+    assert( (bits >= 1) && (dimension*bits <= 8*int( sizeof( Key ) )) );
+    switch( type() )
+    {
+    case morton:
+      return mortonKey( x, bits );
+    case hilbert:
+      return hilbertKey( x, bits );
+    default:
+      {
+        Key key = 0;
+        for( int i = dimension-1; i >= 0; --i )
+          key = (key << bits) | Key( x[ i ] );
+        return key;
+      }
+    }
+  }
+
+
+  template< int dim >
+  template< class Index >
+  inline std::vector< Index > SPOrdering< dim >::order ( const MultiIndex &width ) const
+  {
+    Index size = 1;
+    int bits = 1;
+    for( int i = 0; i < dimension; ++i )
+    {
+      assert( width[ i ] > 0 );
+      size *= Index( width[ i ] );
+      while( (1 << bits) < width[ i ] )
+        ++bits;
+    }
+    if( dimension*bits > 8*int( sizeof( Key ) ) )
+      DUNE_THROW( GridError, "Partition too large for " << name() << " ordering." );
+
+    std::vector< std::pair< Key, Index > > keys;
+    keys.reserve( size );
+    MultiIndex x = MultiIndex::zero();
+    for( Index index = 0; index < size; ++index )
+    {
+      keys.emplace_back( key( x, bits ), index );
+      for( int i = 0; (i < dimension) && (++x[ i ] == width[ i ]); ++i )
+        x[ i ] = 0;
+    }
+    std::sort( keys.begin(), keys.end() );
+
+    std::vector< Index > order;
+    order.reserve( size );
+    for( const auto &k : keys )
+      order.push_back( k.second );
+    return order;
+  }
+
+
+  template< int dim >
+  inline typename SPOrdering< dim >::Key
+  SPOrdering< dim >::mortonKey ( const MultiIndex &x, int bits )
+  {
+    Key key = 0;
+    for( int b = bits-1; b >= 0; --b )
+    {
+      for( int i = dimension-1; i >= 0; --i )
+        key = (key << 1) | Key( (x[ i ] >> b) & 1 );
+    }
+    return key;
+  }
+
+
+  template< int dim >
+  inline typename SPOrdering< dim >::Key
+  SPOrdering< dim >::hilbertKey ( const MultiIndex &x, int bits )
+  {
+    // J. Skilling, Programming the Hilbert curve, AIP Conf. Proc. 707 (2004)
+    std::array< unsigned int, dimension > X;
+    for( int i = 0; i < dimension; ++i )
+      X[ i ] = x[ i ];
+
+    const unsigned int M = 1u << (bits-1);
+
+    // inverse undo
+    for( unsigned int Q = M; Q > 1; Q >>= 1 )
+    {
+      const unsigned int P = Q-1;
+      for( int i = 0; i < dimension; ++i )
+      {
+        if( X[ i ] & Q )
+          X[ 0 ] ^= P;
+        else
+        {
+          const unsigned int t = (X[ 0 ] ^ X[ i ]) & P;
+          X[ 0 ] ^= t;
+          X[ i ] ^= t;
+        }
+      }
+    }
+
+    // Gray encode
+    for( int i = 1; i < dimension; ++i )
+      X[ i ] ^= X[ i-1 ];
+    unsigned int t = 0;
+    for( unsigned int Q = M; Q > 1; Q >>= 1 )
+    {
+      if( X[ dimension-1 ] & Q )
+        t ^= Q-1;
+    }
+    for( int i = 0; i < dimension; ++i )
+      X[ i ] ^= t;
+
+    // interleave transposed representation
+    Key key = 0;
+    for( int b = bits-1; b >= 0; --b )
+    {
+      for( int i = 0; i < dimension; ++i )
+        key = (key << 1) | Key( (X[ i ] >> b) & 1 );
+    }
+    return key;
+  }
+
+
+
+  // Implementation of SPPartitionOrdering
+  // -------------------------------------
+
+  template< int dim, class Index >
+  inline SPPartitionOrdering< dim, Index >
+    ::SPPartitionOrdering ( const Ordering &ordering, const PartitionList &partitions )
+    : ordering_( ordering ),
+      partitions_( partitions ),
+      tables_( partitions.maxNumber() - partitions.minNumber() + 1 )
+  {
+    for( typename PartitionList::Iterator pit = partitions.begin(); pit; ++pit )
+    {
+      for( unsigned int dir = 0; dir < numDirections; ++dir )
+      {
+        if( pit->empty( typename Partition::Direction( dir ) ) )
+          continue;
+
+        MultiIndex width;
+        for( int j = 0; j < dimension; ++j )
+        {
+          const unsigned int d = (dir >> j) & 1;
+          width[ j ] = ((pit->bound( 1, j, d ) - pit->bound( 0, j, d )) >> 1) + 1;
+        }
+
+        Table &table = tables_[ pit->number() - partitions.minNumber() ][ dir ];
+        table.order = ordering.template order< Index >( width );
+        table.rank.resize( table.order.size() );
+        for( Index position = 0; position < Index( table.order.size() ); ++position )
+          table.rank[ table.order[ position ] ] = position;
+      }
+    }
+  }
+
+
+  template< int dim, class Index >
+  inline typename SPPartitionOrdering< dim, Index >::MultiIndex
+  SPPartitionOrdering< dim, Index >::id ( unsigned int number, unsigned int dir, Index position ) const
+  {
+    const Partition &partition = partitions().partition( number );
+
+    Index index = table( number, dir ).order[ position ];
+    MultiIndex id;
+    for( int j = 0; j < dimension; ++j )
+    {
+      const unsigned int d = (dir >> j) & 1;
+      const int begin = partition.bound( 0, j, d );
+      const Index width = ((partition.bound( 1, j, d ) - begin) >> 1) + 1;
+      id[ j ] = begin + 2*int( index % width );
+      index /= width;
+    }
+    return id;
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_ORDERING_HH
@@ -0,0 +1,251 @@
+#ifndef DUNE_SPGRID_PARALLEL_HH
+#define DUNE_SPGRID_PARALLEL_HH
+
+#include <utility>
+#include <vector>
+
+#include <dune/geometry/dimension.hh>
+
+#include <dune/grid/common/gridenums.hh>
+#include <dune/grid/common/gridview.hh>
+
+#include <dune/grid/spgrid/multiindex.hh>
+#include <dune/grid/spgrid/partitionlist.hh>
+#include <dune/grid/spgrid/threadpool.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  thread-parallel loops over the entities of a grid view
+ */
+
+namespace Dune
+{
+
+  // defaultThreadPool
+  // -----------------
+
+  /** \brief thread pool used by parallelForEach if none is specified */
+  inline SPThreadPool &defaultThreadPool ()
+  {
+    static SPThreadPool pool;
+    return pool;
+  }
+
+
+
+  namespace __SPGrid
+  {
+
+    // makeTasks
+    // ---------
+
+    template< class Iterator, class IteratorImpl, class GridLevel, class PartitionList, class F, class... Args >
+    inline std::vector< SPThreadPool::Task >
+    makeTasks ( const GridLevel &gridLevel, const std::vector< PartitionList > &lists, F &f, const Args &... args )
+    {
+      std::vector< SPThreadPool::Task > tasks;
+      tasks.reserve( lists.size() );
+      for( const PartitionList &list : lists )
+      {
+        if( list.empty() )
+          continue;
+
+        tasks.emplace_back( [ &gridLevel, &list, &f, args... ] () {
+            const Iterator end = IteratorImpl( gridLevel, list, typename IteratorImpl::End() );
+            for( Iterator it = IteratorImpl( gridLevel, list, typename IteratorImpl::Begin(), args... ); it != end; ++it )
+              f( *it );
+          } );
+      }
+      return tasks;
+    }
+
+
+    // wavefront
+    // ---------
+
+    /**
+     * \brief split a partition into blocks grouped by wavefront level
+     *
+     * The level of a block is the sum of its block coordinates, counted in
+     * sweep direction. Blocks of the same level are independent with respect
+     * to face neighbors.
+     */
+    template< int dim >
+    inline std::vector< std::vector< SPPartitionList< dim > > >
+    wavefront ( const SPPartition< dim > &partition, unsigned int sweepDir, const SPMultiIndex< dim > &blockSize )
+    {
+      const SPMultiIndex< dim > width = partition.width();
+
+      SPMultiIndex< dim > size, numBlocks;
+      int numLevels = 1;
+      for( int i = 0; i < dim; ++i )
+      {
+        size[ i ] = (blockSize[ i ] > 0 ? blockSize[ i ] : std::max( width[ i ], 1 ));
+        numBlocks[ i ] = std::max( (width[ i ] + size[ i ] - 1) / size[ i ], 1 );
+        numLevels += numBlocks[ i ] - 1;
+      }
+
+      std::vector< std::vector< SPPartitionList< dim > > > levels( numLevels );
+      for( SPMultiIndex< dim > a = SPMultiIndex< dim >::zero(); a[ dim-1 ] < numBlocks[ dim-1 ]; )
+      {
+        SPPartition< dim > block( partition );
+        int level = 0;
+        for( int i = 0; i < dim; ++i )
+        {
+          level += a[ i ];
+
+          // cut out the cells [ q*size, (q+1)*size [ (counting from the first cell)
+          const int q = ((sweepDir >> i) & 1 ? numBlocks[ i ] - 1 - a[ i ] : a[ i ]);
+          const int first = partition.bound( 0, i, 1 );
+          if( q > 0 )
+            block = block.split( i, first + 2*q*size[ i ] - 1, 1 );
+          if( q < numBlocks[ i ]-1 )
+            block = block.split( i, first + 2*(q+1)*size[ i ] - 1, 0 );
+        }
+
+        SPPartitionList< dim > list;
+        list += block;
+        levels[ level ].push_back( std::move( list ) );
+
+        for( int i = 0; (i < dim) && (++a[ i ] == numBlocks[ i ]) && (i < dim-1); ++i )
+          a[ i ] = 0;
+      }
+      return levels;
+    }
+
+
+    // numTasks
+    // --------
+
+    inline unsigned int numTasks ( const SPThreadPool &pool )
+    {
+      // use a few tasks per thread to allow for work stealing
+      return (pool.size() > 1 ? 4*pool.size() : 1u);
+    }
+
+  } // namespace __SPGrid
+
+
+
+  // parallelForEach
+  // ---------------
+
+  /**
+   * \brief call a function for each entity of a grid view in parallel
+   *
+   * The partitions of the grid view are split into balanced sub-boxes
+   * (see SPPartitionList::split), each of which is traversed by one task of
+   * the thread pool. Each entity is passed to f exactly once, but the order
+   * is unspecified; f must be safe to call concurrently.
+   *
+   * \param[in]  gridView  grid view to traverse
+   * \param[in]  codim     codimension of the entities to traverse
+   * \param[in]  f         function to call for each entity
+   * \param      pool      thread pool to execute the tasks
+   *
+   * \tparam  pitype  partition to traverse
+   */
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEach ( const GridView< VT > &gridView, Codim< codim >, F &&f, SPThreadPool &pool )
+  {
+    typedef typename GridView< VT >::Implementation::template Codim< codim >::template Partition< pitype > Traits;
+    typedef typename Traits::IteratorImpl IteratorImpl;
+    typedef typename Traits::Iterator Iterator;
+
+    const auto &gridLevel = gridView.impl().gridLevel();
+    const auto lists = gridLevel.template partition< pitype >().split( __SPGrid::numTasks( pool ) );
+    pool.execute( __SPGrid::makeTasks< Iterator, IteratorImpl >( gridLevel, lists, f ) );
+  }
+
+
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEach ( const GridView< VT > &gridView, Codim< codim > cd, F &&f )
+  {
+    parallelForEach< pitype >( gridView, cd, std::forward< F >( f ), defaultThreadPool() );
+  }
+
+
+
+  // parallelForEachColored
+  // ----------------------
+
+  /**
+   * \brief call a function for each entity of a grid view in parallel, one
+   *        color after the other
+   *
+   * The entities are traversed in 2^dim phases, one per color class (see
+   * SPPartitionIterator::Color). Within each phase, the entities are
+   * processed in parallel as in parallelForEach. As two cells of the same
+   * color never share a subentity, cell contributions can be accumulated
+   * into data attached to subentities without synchronization.
+   */
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEachColored ( const GridView< VT > &gridView, Codim< codim >, F &&f, SPThreadPool &pool )
+  {
+    typedef typename GridView< VT >::Implementation::template Codim< codim >::template Partition< pitype > Traits;
+    typedef typename Traits::IteratorImpl IteratorImpl;
+    typedef typename Traits::Iterator Iterator;
+
+    const auto &gridLevel = gridView.impl().gridLevel();
+    const auto lists = gridLevel.template partition< pitype >().split( __SPGrid::numTasks( pool ) );
+    for( unsigned int color = 0; color < IteratorImpl::numColors; ++color )
+    {
+      const typename IteratorImpl::Color c( color );
+      pool.execute( __SPGrid::makeTasks< Iterator, IteratorImpl >( gridLevel, lists, f, c ) );
+    }
+  }
+
+
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEachColored ( const GridView< VT > &gridView, Codim< codim > cd, F &&f )
+  {
+    parallelForEachColored< pitype >( gridView, cd, std::forward< F >( f ), defaultThreadPool() );
+  }
+
+
+
+  // parallelForEachWavefront
+  // ------------------------
+
+  /**
+   * \brief call a function for each entity of a grid view, sweeping in
+   *        parallel hyperplane wavefronts
+   *
+   * Each partition is cut into blocks of blockSize[ i ] cells along axis i
+   * (a non-positive size disables blocking along that axis). Blocks on the
+   * same anti-diagonal, i.e., with the same sum of block coordinates counted
+   * in sweep direction, are processed in parallel; within a block, the
+   * entities are traversed in sweep direction. Hence, each entity is visited
+   * after all face neighbors preceding it in the sequential sweep, which is
+   * sufficient for Gauss-Seidel type smoothers and upwind transport sweeps.
+   * Partitions are processed one after another.
+   */
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEachWavefront ( const GridView< VT > &gridView, Codim< codim >, F &&f, unsigned int sweepDir,
+                                         const SPMultiIndex< GridView< VT >::dimension > &blockSize, SPThreadPool &pool )
+  {
+    typedef typename GridView< VT >::Implementation::template Codim< codim >::template Partition< pitype > Traits;
+    typedef typename Traits::IteratorImpl IteratorImpl;
+    typedef typename Traits::Iterator Iterator;
+
+    const auto &gridLevel = gridView.impl().gridLevel();
+    for( const auto &partition : gridLevel.template partition< pitype >() )
+    {
+      for( const auto &blocks : __SPGrid::wavefront( partition, sweepDir, blockSize ) )
+        pool.execute( __SPGrid::makeTasks< Iterator, IteratorImpl >( gridLevel, blocks, f, sweepDir ) );
+    }
+  }
+
+
+  template< PartitionIteratorType pitype = All_Partition, class VT, int codim, class F >
+  inline void parallelForEachWavefront ( const GridView< VT > &gridView, Codim< codim > cd, F &&f, unsigned int sweepDir = 0 )
+  {
+    SPMultiIndex< GridView< VT >::dimension > blockSize;
+    for( int i = 0; i < GridView< VT >::dimension; ++i )
+      blockSize[ i ] = 8;
+    parallelForEachWavefront< pitype >( gridView, cd, std::forward< F >( f ), sweepDir, blockSize, defaultThreadPool() );
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_PARALLEL_HH
@@ -1,6 +1,8 @@
 #ifndef DUNE_SPGRID_PARTITION_HH
 #define DUNE_SPGRID_PARTITION_HH
 
+#include <cstddef>
+
 #include <array>
 #include <limits>
 
@@ -49,12 +51,26 @@ namespace Dune
       return This( std::max( begin(), other.begin() ), std::min( end(), other.end() ) );
     }
 
+    /**
+     * \brief split the partition along an axis
+     *
+     * The cells in front of the vertex coordinate m (along axis i) are
+     * assigned to the lower half (b = 0), the remaining cells to the upper
+     * half (b = 1). Lower dimensional entities on the splitting plane belong
+     * to the upper half, so each entity belongs to exactly one half.
+     */
+    This split ( int i, int m, unsigned int b ) const;
+
     bool contains ( const MultiIndex &id ) const;
 
     bool empty () const;
     bool empty ( Direction dir ) const;
 
-    int volume () const;
+    std::size_t volume () const;
+
+    /** \brief number of entities with given direction */
+    std::size_t volume ( Direction dir ) const;
+
     MultiIndex width () const;
     int width ( int i ) const { return std::max( (end()[ i ]+1)/2 - begin()[ i ]/2, 0 ); }
 
@@ -94,6 +110,8 @@ namespace Dune
     SPPartition ( const MultiIndex &begin, const MultiIndex &end,
                   const Mesh &globalMesh, const unsigned int number );
 
+    This split ( int i, int m, unsigned int b ) const;
+
     unsigned int number () const;
     const unsigned int &neighbor ( const int face ) const;
     unsigned int &neighbor ( const int face );
@@ -113,6 +131,18 @@ namespace Dune
   // Implementation of SPBasicPartition
   // ----------------------------------
 
+  template< int dim >
+  inline typename SPBasicPartition< dim >::This
+  SPBasicPartition< dim >::split ( int i, int m, unsigned int b ) const
+  {
+    assert( (m % 2 == 0) && (m > begin()[ i ]) && (m <= end()[ i ]) );
+    assert( b == (b & 1) );
+    std::array< MultiIndex, 2 > bound = bound_;
+    bound[ 1-b ][ i ] = m - int( 1-b );
+    return This( bound[ 0 ], bound[ 1 ] );
+  }
+
+
   template< int dim >
   inline bool SPBasicPartition< dim >::contains ( const MultiIndex &id ) const
   {
@@ -144,11 +174,21 @@ namespace Dune
 
 
   template< int dim >
-  inline int SPBasicPartition< dim >::volume () const
+  inline std::size_t SPBasicPartition< dim >::volume () const
+  {
+    std::size_t volume = 1;
+    for( int i = 0; i < dimension; ++i )
+      volume *= std::size_t( width( i ) );
+    return volume;
+  }
+
+
+  template< int dim >
+  inline std::size_t SPBasicPartition< dim >::volume ( Direction dir ) const
   {
-    int volume = 1;
+    std::size_t volume = 1;
     for( int i = 0; i < dimension; ++i )
-      volume *= width( i );
+      volume *= std::size_t( std::max( (bound( 1, i, dir[ i ] ) - bound( 0, i, dir[ i ] ))/2 + 1, 0 ) );
     return volume;
   }
 
@@ -238,6 +278,21 @@ namespace Dune
   }
 
 
+  template< int dim >
+  inline typename SPPartition< dim >::This
+  SPPartition< dim >::split ( int i, int m, unsigned int b ) const
+  {
+    This partition( *this );
+    static_cast< Base & >( partition ) = Base::split( i, m, b );
+
+    // the splitting plane is neither a process boundary nor a domain boundary
+    const int face = 2*i + int( 1-b );
+    partition.neighbor_[ face ] = std::numeric_limits< unsigned int >::max();
+    partition.boundary_ &= ~(Flags( 1 ) << face);
+    return partition;
+  }
+
+
   template< int dim >
   inline unsigned int SPPartition< dim >::number () const
   {
@@ -1,7 +1,11 @@
 #ifndef DUNE_SPGRID_PARTITIONLIST_HH
 #define DUNE_SPGRID_PARTITIONLIST_HH
 
+#include <cstddef>
+
+#include <algorithm>
 #include <iterator>
+#include <vector>
 
 #include <dune/grid/spgrid/partition.hh>
 
@@ -57,12 +61,28 @@ namespace Dune
 
     bool contains ( const MultiIndex &id, unsigned int number ) const;
     const Partition *findPartition ( const MultiIndex &id ) const;
-    int volume () const;
+    std::size_t volume () const;
+
+    /** \brief number of entities of given codimension */
+    std::size_t volume ( int codim ) const;
 
     bool empty () const { return !head_; }
     unsigned int size () const;
 
+    /**
+     * \brief split the partition list into n lists of balanced volume
+     *
+     * The partitions are cut into disjoint sub-boxes by recursive coordinate
+     * bisection; each entity of the list is contained in exactly one of the
+     * returned lists. The sub-boxes keep the number of their partition.
+     *
+     * \note Some of the lists may be empty if there are too few cells.
+     */
+    std::vector< This > split ( unsigned int n ) const;
+
   protected:
+    static void bisect ( const Partition &partition, unsigned int k, std::vector< This > &lists, std::vector< std::size_t > &load, unsigned int &next );
+
     Node *head_;
   };
 
@@ -194,15 +214,33 @@ namespace Dune
 
 
   template< int dim >
-  inline int SPPartitionList< dim >::volume () const
+  inline std::size_t SPPartitionList< dim >::volume () const
   {
-    int volume = 0;
+    std::size_t volume = 0;
     for( const Node *it = head_; it; it = it->next() )
       volume += it->partition().volume();
     return volume;
   }
 
 
+  template< int dim >
+  inline std::size_t SPPartitionList< dim >::volume ( int codim ) const
+  {
+    typedef typename Partition::Direction Direction;
+
+    std::size_t volume = 0;
+    for( const Node *it = head_; it; it = it->next() )
+    {
+      for( unsigned long dir = 0; dir < (1ul << dim); ++dir )
+      {
+        if( Direction( dir ).codimension() == codim )
+          volume += it->partition().volume( Direction( dir ) );
+      }
+    }
+    return volume;
+  }
+
+
   template< int dim >
   inline unsigned int SPPartitionList< dim >::size () const
   {
@@ -214,6 +252,77 @@ namespace Dune
 
 
 
+  template< int dim >
+  inline std::vector< SPPartitionList< dim > > SPPartitionList< dim >::split ( unsigned int n ) const
+  {
+    assert( n > 0 );
+    std::vector< This > lists( n );
+    std::vector< std::size_t > load( n, 0 );
+
+    // distribute the parts proportionally to the volume (largest remainder method)
+    const long volume = this->volume();
+    std::vector< const Partition * > partitions;
+    std::vector< unsigned int > parts;
+    std::vector< std::pair< long, std::size_t > > remainders;
+    unsigned int assigned = 0;
+    for( const Node *it = head_; it; it = it->next() )
+    {
+      const long share = (volume > 0 ? long( n ) * long( it->partition().volume() ) : 0);
+      partitions.push_back( &(it->partition()) );
+      parts.push_back( volume > 0 ? share / volume : 0u );
+      remainders.emplace_back( (volume > 0 ? share % volume : 0), remainders.size() );
+      assigned += parts.back();
+    }
+    std::sort( remainders.begin(), remainders.end(), [] ( const auto &a, const auto &b ) { return (a.first > b.first); } );
+    for( std::size_t j = 0; (assigned < n) && (j < remainders.size()) && (remainders[ j ].first > 0); ++j, ++assigned )
+      ++parts[ remainders[ j ].second ];
+
+    unsigned int next = 0;
+    for( std::size_t j = 0; j < partitions.size(); ++j )
+    {
+      if( parts[ j ] > 0 )
+        bisect( *partitions[ j ], parts[ j ], lists, load, next );
+    }
+
+    // partitions without cells go to the least loaded list
+    for( std::size_t j = 0; j < partitions.size(); ++j )
+    {
+      if( parts[ j ] == 0 )
+      {
+        const std::size_t k = std::min_element( load.begin(), load.end() ) - load.begin();
+        lists[ k ] += *partitions[ j ];
+        load[ k ] += partitions[ j ]->volume();
+      }
+    }
+
+    return lists;
+  }
+
+
+  template< int dim >
+  inline void SPPartitionList< dim >
+    ::bisect ( const Partition &partition, unsigned int k, std::vector< This > &lists, std::vector< std::size_t > &load, unsigned int &next )
+  {
+    const MultiIndex width = partition.width();
+    const int axis = std::max_element( width.begin(), width.end() ) - width.begin();
+    if( (k == 1) || (width[ axis ] < 2) )
+    {
+      lists[ next ] += partition;
+      load[ next ] += partition.volume();
+      next += k;
+      return;
+    }
+
+    // cut after c cells, the first cell being located at bound( 0, axis, 1 )
+    const unsigned int k0 = k / 2;
+    const int c = std::min( std::max( int( (long( width[ axis ] ) * k0 + k/2) / k ), 1 ), width[ axis ]-1 );
+    const int m = partition.bound( 0, axis, 1 ) + 2*c - 1;
+    bisect( partition.split( axis, m, 0 ), k0, lists, load, next );
+    bisect( partition.split( axis, m, 1 ), k - k0, lists, load, next );
+  }
+
+
+
   // Auxilliary Functions for SPPartitionList
   // ----------------------------------------
 
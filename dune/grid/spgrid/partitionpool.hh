@@ -22,6 +22,7 @@ namespace Dune
     static const int dimension = dim;
 
     typedef SPCachedPartitionList< dimension > PartitionList;
+    typedef SPPartitionList< dimension > BasicPartitionList;
     typedef SPTopology< dimension > Topology;
 
     typedef typename PartitionList::Partition Partition;
@@ -34,6 +35,18 @@ namespace Dune
     template< PartitionIteratorType pitype >
     const PartitionList &get () const;
 
+    /**
+     * \brief interior entities that do not depend on overlap data
+     *
+     * The deep interior consists of the interior entities whose distance
+     * from each process boundary is at least the overlap width (at least one
+     * cell layer for entities on the process boundary).
+     */
+    const BasicPartitionList &deepInterior () const { return deepInteriorList_; }
+
+    /** \brief interior border entities not contained in the deep interior */
+    const BasicPartitionList &shell () const { return shellList_; }
+
     template< int codim >
     PartitionType
     partitionType ( const MultiIndex &id, const unsigned int number ) const;
@@ -46,6 +59,8 @@ namespace Dune
     Partition makePartition ( const Mesh &localMesh, const unsigned int number,
                               const unsigned int open ) const;
 
+    void makeDeepInterior ( const Mesh &localMesh );
+
     Mesh globalMesh_;
     MultiIndex overlap_;
     Topology topology_;
@@ -56,6 +71,8 @@ namespace Dune
     PartitionList overlapFrontList_;
     PartitionList allList_;
     PartitionList ghostList_;
+    BasicPartitionList deepInteriorList_;
+    BasicPartitionList shellList_;
   };
 
 
@@ -77,6 +94,10 @@ namespace Dune
     interiorList_.updateCache();
     interiorBorderList_.updateCache();
 
+    // generate deep interior and shell (the latter may consist of multiple
+    // boxes with the same number, so they are not cached)
+    makeDeepInterior( localMesh );
+
     // detect which directions have to be split in the overlap partition
     const MultiIndex globalWidth = globalMesh.width();
     Mesh overlapMesh = localMesh.grow( overlap );
@@ -220,6 +241,59 @@ namespace Dune
     return partition;
   }
 
+
+  template< int dim >
+  inline void SPPartitionPool< dim >::makeDeepInterior ( const Mesh &localMesh )
+  {
+    const MultiIndex &lbegin = localMesh.begin();
+    const MultiIndex &lend = localMesh.end();
+    const MultiIndex &gbegin = globalMesh().begin();
+    const MultiIndex &gend = globalMesh().end();
+
+    // remove overlap width (and the boundary layer) at process boundaries
+    const Partition &interiorBorder = *interiorBorderList_.begin();
+    MultiIndex begin = interiorBorder.begin();
+    MultiIndex end = interiorBorder.end();
+    bool empty = false;
+    for( int i = 0; i < dimension; ++i )
+    {
+      const bool periodic = topology().hasNeighbor( 0, 2*i );
+      if( periodic || (lbegin[ i ] != gbegin[ i ]) )
+        begin[ i ] += 2*overlap()[ i ] + 1;
+      if( periodic || (lend[ i ] != gend[ i ]) )
+        end[ i ] -= 2*overlap()[ i ] + 1;
+      empty |= (begin[ i ] > end[ i ]);
+    }
+
+    if( empty )
+    {
+      shellList_ = interiorBorderList_;
+      return;
+    }
+
+    // the shell consists of (at most) two slabs per direction
+    MultiIndex rbegin = interiorBorder.begin();
+    MultiIndex rend = interiorBorder.end();
+    for( int i = 0; i < dimension; ++i )
+    {
+      if( begin[ i ] > rbegin[ i ] )
+      {
+        MultiIndex slabEnd = rend;
+        slabEnd[ i ] = begin[ i ]-1;
+        shellList_ += Partition( rbegin, slabEnd, globalMesh(), 0 );
+        rbegin[ i ] = begin[ i ];
+      }
+      if( end[ i ] < rend[ i ] )
+      {
+        MultiIndex slabBegin = rbegin;
+        slabBegin[ i ] = end[ i ]+1;
+        shellList_ += Partition( slabBegin, rend, globalMesh(), 0 );
+        rend[ i ] = end[ i ];
+      }
+    }
+    deepInteriorList_ += Partition( begin, end, globalMesh(), 0 );
+  }
+
 } // namespace Dune
 
 #endif // #ifndef DUNE_SPGRID_PARTITIONPOOL_HH
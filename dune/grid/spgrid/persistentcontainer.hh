@@ -14,11 +14,11 @@ namespace Dune
   // PersistentContainer for SPGrid
   // ------------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm, class T >
-  class PersistentContainer< SPGrid< ct, dim, Ref, Comm >, T >
-    : public PersistentContainerVector< SPGrid< ct, dim, Ref, Comm >, typename SPGrid< ct, dim, Ref, Comm >::HierarchicIndexSet, std::vector< T > >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index, class T >
+  class PersistentContainer< SPGrid< ct, dim, Ref, Comm, Index >, T >
+    : public PersistentContainerVector< SPGrid< ct, dim, Ref, Comm, Index >, typename SPGrid< ct, dim, Ref, Comm, Index >::HierarchicIndexSet, std::vector< T > >
   {
-    typedef PersistentContainerVector< SPGrid< ct, dim, Ref, Comm >, typename SPGrid< ct, dim, Ref, Comm >::HierarchicIndexSet, std::vector< T > > Base;
+    typedef PersistentContainerVector< SPGrid< ct, dim, Ref, Comm, Index >, typename SPGrid< ct, dim, Ref, Comm, Index >::HierarchicIndexSet, std::vector< T > > Base;
 
   public:
     typedef typename Base::Grid Grid;
@@ -0,0 +1,56 @@
+#ifndef DUNE_SPGRID_REFINEMENTOBSERVER_HH
+#define DUNE_SPGRID_REFINEMENTOBSERVER_HH
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  notification about newly created grid levels
+ */
+
+namespace Dune
+{
+
+  // SPRefinementObserver
+  // --------------------
+
+  /**
+   * \class SPRefinementObserver
+   * \brief interface for objects to be notified about global refinement
+   *
+   * An observer is attached to a grid by SPGrid::attach. After each new grid
+   * level has been created (and all index sets have been updated), the grid
+   * calls refined with the number of the new level. An observer detaches
+   * itself on destruction; if the grid is destroyed first, the observer is
+   * detached by the grid.
+   */
+  template< class Grid >
+  class SPRefinementObserver
+  {
+    typedef SPRefinementObserver< Grid > This;
+
+    friend Grid;
+
+  public:
+    SPRefinementObserver () = default;
+
+    SPRefinementObserver ( const This & ) = delete;
+    This &operator= ( const This & ) = delete;
+
+    virtual ~SPRefinementObserver ()
+    {
+      if( grid_ )
+        grid_->detach( *this );
+    }
+
+    /** \brief grid the observer is attached to (nullptr if detached) */
+    const Grid *observedGrid () const { return grid_; }
+
+    /** \brief called after the grid level with given number was created */
+    virtual void refined ( int level ) = 0;
+
+  private:
+    const Grid *grid_ = nullptr;
+  };
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_REFINEMENTOBSERVER_HH
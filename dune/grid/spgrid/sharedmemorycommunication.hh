@@ -0,0 +1,366 @@
+#ifndef DUNE_SPGRID_SHAREDMEMORYCOMMUNICATION_HH
+#define DUNE_SPGRID_SHAREDMEMORYCOMMUNICATION_HH
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/parallel/communication.hh>
+#include <dune/common/parallel/mpicommunication.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
+#include <dune/grid/spgrid/vectorcommunication.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  communication of vectors indexed by an SPIndexSet through shared
+ *          memory for neighbors on the same node
+ */
+
+namespace Dune
+{
+
+  namespace __SPGrid
+  {
+
+    // MemoryBuffer
+    // ------------
+
+    /** \brief sequential reading and writing of raw memory (without bounds checking) */
+    class MemoryBuffer
+    {
+    public:
+      explicit MemoryBuffer ( char *position ) : position_( position ) {}
+
+      template< class T >
+      void write ( const T *values, std::size_t n )
+      {
+        std::memcpy( position_, values, n*sizeof( T ) );
+        position_ += n*sizeof( T );
+      }
+
+      template< class T >
+      void read ( T *values, std::size_t n )
+      {
+        std::memcpy( static_cast< void * >( values ), position_, n*sizeof( T ) );
+        position_ += n*sizeof( T );
+      }
+
+      const char *position () const { return position_; }
+
+    private:
+      char *position_;
+    };
+
+  } // namespace __SPGrid
+
+
+
+  // SPSharedMemoryCommunication
+  // ---------------------------
+
+  /**
+   * \class SPSharedMemoryCommunication
+   * \brief communication of a vector indexed by an SPIndexSet through shared
+   *        memory for neighbors on the same node
+   *
+   * On construction, the links of the communication interface are split into
+   * intra-node links (neighbors in the same MPI_COMM_TYPE_SHARED
+   * communicator) and off-node links. For the intra-node links, each process
+   * places its packed send data into its segment of an MPI-3 shared window,
+   * from which the neighbor unpacks them directly. Two counters per link
+   * synchronize both sides: the owner publishes the number of the exchange
+   * whose data are ready, the neighbor reports the last exchange it has
+   * consumed. Off-node links use packed point-to-point messages.
+   *
+   * \code
+   * SPSharedMemoryCommunication< Grid, double > communication( gridView.indexSet(), codim, iftype, dir );
+   * communication.start( data );
+   * // compute something else
+   * communication.wait();
+   * \endcode
+   *
+   * \note Construction and destruction are collective on the grid's
+   *       communicator. Exchanges must be started in the same order on all
+   *       processes. The vector must not be reallocated while a
+   *       communication is in progress.
+   */
+  template< class Grid, class T, class Comm = typename Grid::Communication >
+  class SPSharedMemoryCommunication
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPSharedMemoryCommunication< Grid, T, Comm > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+
+    SPSharedMemoryCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 )
+      : Base( indexSet, codim, iftype, dir, blockSize )
+    {
+      assert( this->interface_.size() == 0u );
+    }
+
+    void start ( std::vector< T > &data ) { this->checkSize( data ); }
+    void wait () {}
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return true; }
+
+    /** \brief number of links served through shared memory */
+    std::size_t sharedLinks () const { return 0u; }
+  };
+
+#if HAVE_MPI
+  template< class Grid, class T >
+  class SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > >
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+    typedef std::atomic< std::uint64_t > Flag;
+    static_assert( Flag::is_always_lock_free, "SPSharedMemoryCommunication requires lock-free 64 bit atomics." );
+
+    typedef SPPackedMessageWriteBuffer< Communication< MPI_Comm > > WriteBuffer;
+    typedef SPPackedMessageReadBuffer< Communication< MPI_Comm > > ReadBuffer;
+
+    struct SharedLink
+    {
+      typename Base::Interface::Iterator link;
+      int nodeRank;
+      std::size_t sendOffset;
+      Flag *ready, *consumed;
+      char *remoteData;
+      Flag *remoteReady, *remoteConsumed;
+    };
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+    typedef typename Base::Interface Interface;
+
+    SPSharedMemoryCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize = 1 );
+
+    SPSharedMemoryCommunication ( const This & ) = delete;
+
+    ~SPSharedMemoryCommunication ();
+
+    This &operator= ( const This & ) = delete;
+
+    void start ( std::vector< T > &data );
+    void wait ();
+
+    void exchange ( std::vector< T > &data ) { start( data ); wait(); }
+
+    bool ready () const { return !data_; }
+
+    /** \brief number of links served through shared memory */
+    std::size_t sharedLinks () const { return sharedLinks_.size(); }
+
+  private:
+    void waitFor ( const Flag &flag, std::uint64_t epoch ) const
+    {
+      while( flag.load( std::memory_order_acquire ) < epoch )
+      {
+        MPI_Win_sync( window_ );
+        std::this_thread::yield();
+      }
+    }
+
+    const Communication< MPI_Comm > &comm_;
+    SPMessageBufferPool &pool_;
+    MPI_Comm nodeComm_;
+    MPI_Win window_;
+    char *segment_;
+    std::vector< SharedLink > sharedLinks_;
+    std::vector< typename Interface::Iterator > remoteLinks_;
+    std::uint64_t epoch_ = 0;
+    SPCommTag tag_;
+    std::vector< WriteBuffer > writeBuffers_;
+    std::vector< ReadBuffer > readBuffers_;
+    std::vector< T > *data_ = nullptr;
+  };
+#endif // #if HAVE_MPI
+
+
+
+#if HAVE_MPI
+  // Implementation of SPSharedMemoryCommunication
+  // ---------------------------------------------
+
+  template< class Grid, class T >
+  inline SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > >
+    ::SPSharedMemoryCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize )
+    : Base( indexSet, codim, iftype, dir, blockSize ),
+      comm_( indexSet.gridLevel().grid().messageComm() ),
+      pool_( indexSet.gridLevel().bufferPool() )
+  {
+    MPI_Comm_split_type( comm_, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &nodeComm_ );
+
+    // find the neighbors on this node
+    std::vector< int > ranks, nodeRanks( this->interface_.size() );
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+      ranks.push_back( it->rank() );
+
+    MPI_Group group, nodeGroup;
+    MPI_Comm_group( comm_, &group );
+    MPI_Comm_group( nodeComm_, &nodeGroup );
+    MPI_Group_translate_ranks( group, int( ranks.size() ), ranks.data(), nodeGroup, nodeRanks.data() );
+    MPI_Group_free( &nodeGroup );
+    MPI_Group_free( &group );
+
+    typename Interface::Iterator it = this->interface_.begin();
+    for( std::size_t i = 0; i < ranks.size(); ++i, ++it )
+    {
+      if( nodeRanks[ i ] != MPI_UNDEFINED )
+        sharedLinks_.push_back( SharedLink{ it, nodeRanks[ i ], 0, nullptr, nullptr, nullptr, nullptr, nullptr } );
+      else
+        remoteLinks_.push_back( it );
+    }
+
+    // segment layout: two flags per shared link, followed by the send data
+    const std::size_t alignment = alignof( std::max_align_t );
+    std::size_t segmentSize = 2*sharedLinks_.size()*sizeof( Flag );
+    for( SharedLink &link : sharedLinks_ )
+    {
+      segmentSize = (segmentSize + alignment - 1) / alignment * alignment;
+      link.sendOffset = segmentSize;
+      segmentSize += this->messageSize( link.link->sendList( dir ) );
+    }
+
+    MPI_Win_allocate_shared( MPI_Aint( segmentSize ), 1, MPI_INFO_NULL, nodeComm_, &segment_, &window_ );
+    MPI_Win_lock_all( MPI_MODE_NOCHECK, window_ );
+
+    for( std::size_t i = 0; i < sharedLinks_.size(); ++i )
+    {
+      sharedLinks_[ i ].ready = new( segment_ + (2*i)*sizeof( Flag ) ) Flag( 0 );
+      sharedLinks_[ i ].consumed = new( segment_ + (2*i+1)*sizeof( Flag ) ) Flag( 0 );
+    }
+
+    // exchange slot number and data offset with each neighbor on this node
+    SPCommTag tag( indexSet.gridLevel().grid().tagAllocator() );
+    std::vector< unsigned long > sendInfo( 2*sharedLinks_.size() ), receiveInfo( 2*sharedLinks_.size() );
+    std::vector< MPI_Request > requests( 2*sharedLinks_.size() );
+    for( std::size_t i = 0; i < sharedLinks_.size(); ++i )
+    {
+      sendInfo[ 2*i ] = i;
+      sendInfo[ 2*i+1 ] = sharedLinks_[ i ].sendOffset;
+      MPI_Irecv( &receiveInfo[ 2*i ], 2, MPI_UNSIGNED_LONG, sharedLinks_[ i ].link->rank(), tag, comm_, &requests[ 2*i ] );
+      MPI_Isend( &sendInfo[ 2*i ], 2, MPI_UNSIGNED_LONG, sharedLinks_[ i ].link->rank(), tag, comm_, &requests[ 2*i+1 ] );
+    }
+    MPI_Waitall( int( requests.size() ), requests.data(), MPI_STATUSES_IGNORE );
+
+    for( std::size_t i = 0; i < sharedLinks_.size(); ++i )
+    {
+      MPI_Aint size;
+      int dispUnit;
+      char *base = nullptr;
+      MPI_Win_shared_query( window_, sharedLinks_[ i ].nodeRank, &size, &dispUnit, &base );
+      sharedLinks_[ i ].remoteReady = reinterpret_cast< Flag * >( base + (2*receiveInfo[ 2*i ])*sizeof( Flag ) );
+      sharedLinks_[ i ].remoteConsumed = reinterpret_cast< Flag * >( base + (2*receiveInfo[ 2*i ]+1)*sizeof( Flag ) );
+      sharedLinks_[ i ].remoteData = base + receiveInfo[ 2*i+1 ];
+    }
+
+    // make the initialized flags visible on the whole node
+    MPI_Win_sync( window_ );
+    MPI_Barrier( nodeComm_ );
+  }
+
+
+  template< class Grid, class T >
+  inline SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > >::~SPSharedMemoryCommunication ()
+  {
+    wait();
+    MPI_Win_unlock_all( window_ );
+    MPI_Win_free( &window_ );
+    MPI_Comm_free( &nodeComm_ );
+  }
+
+
+  template< class Grid, class T >
+  inline void SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > >::start ( std::vector< T > &data )
+  {
+    if( !ready() )
+      DUNE_THROW( InvalidStateException, "Shared memory communication is already in progress." );
+    this->checkSize( data );
+
+    data_ = &data;
+    ++epoch_;
+
+    // off-node links: packed messages
+    tag_ = SPCommTag( this->indexSet().gridLevel().grid().tagAllocator() );
+    readBuffers_.reserve( remoteLinks_.size() );
+    for( const typename Interface::Iterator &link : remoteLinks_ )
+    {
+      readBuffers_.emplace_back( comm_, pool_ );
+      readBuffers_.back().receive( link->rank(), tag_, this->messageSize( link->receiveList( this->dir_ ) ) );
+    }
+
+    writeBuffers_.reserve( remoteLinks_.size() );
+    for( const typename Interface::Iterator &link : remoteLinks_ )
+    {
+      writeBuffers_.emplace_back( comm_, pool_, link->rank() );
+      __SPGrid::packLines( this->indexSet(), link->sendList( this->dir_ ), this->codimension(), data.data(), this->blockSize(), writeBuffers_.back() );
+      writeBuffers_.back().send( link->rank(), tag_ );
+    }
+
+    // intra-node links: publish the data once the neighbor has consumed the previous ones
+    for( SharedLink &link : sharedLinks_ )
+    {
+      waitFor( *link.remoteConsumed, epoch_-1 );
+      __SPGrid::MemoryBuffer buffer( segment_ + link.sendOffset );
+      __SPGrid::packLines( this->indexSet(), link.link->sendList( this->dir_ ), this->codimension(), data.data(), this->blockSize(), buffer );
+      MPI_Win_sync( window_ );
+      link.ready->store( epoch_, std::memory_order_release );
+    }
+  }
+
+
+  template< class Grid, class T >
+  inline void SPSharedMemoryCommunication< Grid, T, Communication< MPI_Comm > >::wait ()
+  {
+    if( ready() )
+      return;
+
+    for( SharedLink &link : sharedLinks_ )
+    {
+      waitFor( *link.remoteReady, epoch_ );
+      __SPGrid::MemoryBuffer buffer( link.remoteData );
+      __SPGrid::unpackLines( this->indexSet(), link.link->receiveList( this->dir_ ), this->codimension(), data_->data(), this->blockSize(), buffer );
+      link.consumed->store( epoch_, std::memory_order_release );
+    }
+    MPI_Win_sync( window_ );
+
+    for( std::size_t i = 0; i < remoteLinks_.size(); ++i )
+    {
+      const typename std::vector< ReadBuffer >::iterator buffer = waitAny( readBuffers_ );
+      const typename Interface::Iterator link = remoteLinks_[ buffer - readBuffers_.begin() ];
+      __SPGrid::unpackLines( this->indexSet(), link->receiveList( this->dir_ ), this->codimension(), data_->data(), this->blockSize(), *buffer );
+    }
+    readBuffers_.clear();
+
+    for( WriteBuffer &buffer : writeBuffers_ )
+      buffer.wait();
+    writeBuffers_.clear();
+
+    tag_.release();
+    data_ = nullptr;
+  }
+#endif // #if HAVE_MPI
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_SHAREDMEMORYCOMMUNICATION_HH
@@ -0,0 +1,282 @@
+#ifndef DUNE_SPGRID_THREADPOOL_HH
+#define DUNE_SPGRID_THREADPOOL_HH
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  simple work-stealing thread pool
+ */
+
+namespace Dune
+{
+
+  // SPThreadPool
+  // ------------
+
+  /**
+   * \class SPThreadPool
+   * \brief work-stealing thread pool for bulk-synchronous task execution
+   *
+   * Each worker owns a task queue. A worker takes tasks from the back of its
+   * own queue and, once it runs dry, steals tasks from the front of the other
+   * queues. The thread calling execute acts as worker 0.
+   *
+   * The pool serves one caller at a time. If execute is called while the pool
+   * is busy, e.g., by a nested parallelForEach inside a task or by a second
+   * thread sharing the pool, the tasks are executed inline by the calling
+   * thread.
+   *
+   * By default, the pool uses as many workers as given by the environment
+   * variable SPGRID_NUM_THREADS, falling back to the hardware concurrency. In
+   * hybrid MPI runs, set this variable to the number of cores per process to
+   * avoid oversubscription.
+   */
+  class SPThreadPool
+  {
+    typedef SPThreadPool This;
+
+  public:
+    typedef std::function< void () > Task;
+
+    explicit SPThreadPool ( unsigned int numThreads = defaultNumThreads() );
+
+    SPThreadPool ( const This & ) = delete;
+    SPThreadPool ( This && ) = delete;
+
+    ~SPThreadPool ();
+
+    This &operator= ( const This & ) = delete;
+    This &operator= ( This && ) = delete;
+
+    /** \brief number of workers (including the calling thread) */
+    unsigned int size () const { return queues_.size(); }
+
+    /**
+     * \brief execute tasks and wait for their completion
+     *
+     * If a task throws, the remaining tasks are still executed and the first
+     * exception is rethrown afterwards. If the pool is already busy, the
+     * tasks are executed inline.
+     */
+    void execute ( std::vector< Task > tasks );
+
+    /** \brief number of workers given by SPGRID_NUM_THREADS or, if unset, the hardware concurrency */
+    static unsigned int defaultNumThreads ();
+
+  private:
+    struct Queue
+    {
+      std::mutex mutex;
+      std::deque< Task > tasks;
+    };
+
+    static void executeInline ( std::vector< Task > &tasks );
+
+    void work ( unsigned int id );
+    bool runTask ( unsigned int id );
+    bool popTask ( unsigned int id, Task &task );
+
+    std::vector< std::unique_ptr< Queue > > queues_;
+    std::vector< std::thread > threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeUp_, done_;
+    unsigned long generation_ = 0;
+    bool stop_ = false;
+
+    std::atomic< bool > busy_{ false };
+
+    std::atomic< std::size_t > pending_{ 0 };
+    std::exception_ptr exception_;
+  };
+
+
+
+  // Implementation of SPThreadPool
+  // ------------------------------
+
+  inline SPThreadPool::SPThreadPool ( unsigned int numThreads )
+  {
+    numThreads = std::max( numThreads, 1u );
+    for( unsigned int id = 0; id < numThreads; ++id )
+      queues_.emplace_back( new Queue );
+    for( unsigned int id = 1; id < numThreads; ++id )
+      threads_.emplace_back( [ this, id ] () { work( id ); } );
+  }
+
+
+  inline SPThreadPool::~SPThreadPool ()
+  {
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      stop_ = true;
+    }
+    wakeUp_.notify_all();
+    for( std::thread &thread : threads_ )
+      thread.join();
+  }
+
+
+  inline void SPThreadPool::execute ( std::vector< Task > tasks )
+  {
+    if( tasks.empty() )
+      return;
+
+    // pending_ and exception_ belong to a single caller
+    if( busy_.exchange( true ) )
+      return executeInline( tasks );
+
+    pending_ = tasks.size();
+    for( std::size_t i = 0; i < tasks.size(); ++i )
+    {
+      Queue &queue = *queues_[ i % size() ];
+      std::lock_guard< std::mutex > lock( queue.mutex );
+      queue.tasks.push_back( std::move( tasks[ i ] ) );
+    }
+
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      ++generation_;
+    }
+    wakeUp_.notify_all();
+
+    while( pending_ > 0 )
+    {
+      if( !runTask( 0 ) )
+      {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        done_.wait( lock, [ this ] () { return (pending_ == 0); } );
+      }
+    }
+
+    std::exception_ptr exception;
+    std::swap( exception, exception_ );
+    busy_ = false;
+    if( exception )
+      std::rethrow_exception( exception );
+  }
+
+
+  inline unsigned int SPThreadPool::defaultNumThreads ()
+  {
+    if( const char *value = std::getenv( "SPGRID_NUM_THREADS" ) )
+    {
+      char *end = nullptr;
+      const unsigned long numThreads = std::strtoul( value, &end, 10 );
+      if( (end != value) && (*end == '\0') && (numThreads > 0) )
+        return numThreads;
+    }
+    return std::max( std::thread::hardware_concurrency(), 1u );
+  }
+
+
+  inline void SPThreadPool::executeInline ( std::vector< Task > &tasks )
+  {
+    std::exception_ptr exception;
+    for( Task &task : tasks )
+    {
+      try
+      {
+        task();
+      }
+      catch( ... )
+      {
+        if( !exception )
+          exception = std::current_exception();
+      }
+    }
+    if( exception )
+      std::rethrow_exception( exception );
+  }
+
+
+  inline void SPThreadPool::work ( unsigned int id )
+  {
+    unsigned long generation = 0;
+    while( true )
+    {
+      {
+        std::unique_lock< std::mutex > lock( mutex_ );
+        wakeUp_.wait( lock, [ this, generation ] () { return stop_ || (generation_ != generation); } );
+        if( stop_ )
+          return;
+        generation = generation_;
+      }
+
+      while( runTask( id ) )
+        continue;
+    }
+  }
+
+
+  inline bool SPThreadPool::runTask ( unsigned int id )
+  {
+    Task task;
+    if( !popTask( id, task ) )
+      return false;
+
+    try
+    {
+      task();
+    }
+    catch( ... )
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      if( !exception_ )
+        exception_ = std::current_exception();
+    }
+
+    if( --pending_ == 0 )
+    {
+      std::lock_guard< std::mutex > lock( mutex_ );
+      done_.notify_all();
+    }
+    return true;
+  }
+
+
+  inline bool SPThreadPool::popTask ( unsigned int id, Task &task )
+  {
+    // take the most recently queued task from the own queue
+    {
+      Queue &queue = *queues_[ id ];
+      std::lock_guard< std::mutex > lock( queue.mutex );
+      if( !queue.tasks.empty() )
+      {
+        task = std::move( queue.tasks.back() );
+        queue.tasks.pop_back();
+        return true;
+      }
+    }
+
+    // steal the oldest task from another queue
+    for( unsigned int i = 1; i < size(); ++i )
+    {
+      Queue &queue = *queues_[ (id + i) % size() ];
+      std::lock_guard< std::mutex > lock( queue.mutex );
+      if( !queue.tasks.empty() )
+      {
+        task = std::move( queue.tasks.front() );
+        queue.tasks.pop_front();
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_THREADPOOL_HH
@@ -198,10 +198,10 @@ namespace Dune
   // ---------------------
 
   template< int codim, class ct, int dim, template< int > class Ref, class Comm, class IsLeaf >
-  class EntityTree< codim, SPGrid< ct, dim, Ref, Comm >, IsLeaf >
+  class EntityTree< codim, SPGrid< ct, dim, Ref, Comm, Index >, IsLeaf >
   {
   public:
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
     typedef Dune::Entity< codim, dim, const Grid, SPEntity > Entity;
     typedef Dune::EntityIterator< codim, Grid, __SPGrid::TreeIterator< Entity, IsLeaf > > Iterator;
@@ -225,11 +225,11 @@ namespace Dune
   // IntersectionTree for SPGrid
   // ---------------------------
 
-  template< class ct, int dim, template< int > class Ref, class Comm, class IsLeaf >
-  class IntersectionTree< SPGrid< ct, dim, Ref, Comm >, IsLeaf >
+  template< class ct, int dim, template< int > class Ref, class Comm, class Index, class IsLeaf >
+  class IntersectionTree< SPGrid< ct, dim, Ref, Comm, Index >, IsLeaf >
   {
   public:
-    typedef SPGrid< ct, dim, Ref, Comm > Grid;
+    typedef SPGrid< ct, dim, Ref, Comm, Index > Grid;
 
     typedef Dune::Intersection< const Grid, SPIntersection< const Grid > > Intersection;
     typedef Dune::IntersectionIterator< const Grid, __SPGrid::TreeIterator< Intersection, IsLeaf >, SPIntersection< const Grid > > Iterator;
@@ -0,0 +1,161 @@
+#ifndef DUNE_SPGRID_UNIFORMGEOMETRY_HH
+#define DUNE_SPGRID_UNIFORMGEOMETRY_HH
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include <dune/common/fvector.hh>
+
+#include <dune/geometry/quadraturerules.hh>
+
+#include <dune/grid/spgrid/geometricgridlevel.hh>
+#include <dune/grid/spgrid/normal.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  geometry data shared by all elements of a grid level
+ */
+
+namespace Dune
+{
+
+  // SPUniformGeometry
+  // -----------------
+
+  /**
+   * \class SPUniformGeometry
+   * \brief geometry data shared by all elements of a grid level, evaluated
+   *        for a quadrature rule
+   *
+   * All elements of an SPGrid level are translates of each other. Hence, the
+   * Jacobian, the integration element and the face normals are the same for
+   * all elements. This class precomputes
+   * - the integration weights (quadrature weight times integration element),
+   * - the diagonal of the inverse transposed Jacobian, mapping local to global
+   *   gradients, and the weighted products needed for
+   *   <tt>grad u * grad v</tt>,
+   * - the integration outer normals (unit outer normal times face volume),
+   * so that matrix-free operators can hoist all geometry out of the element
+   * loop.
+   *
+   * \note The object keeps no reference to the grid level.
+   */
+  template< class ct, int dim >
+  class SPUniformGeometry
+  {
+    typedef SPUniformGeometry< ct, dim > This;
+
+  public:
+    typedef SPGeometricGridLevel< ct, dim > GeometricGridLevel;
+
+    typedef typename GeometricGridLevel::ctype ctype;
+    static const int dimension = GeometricGridLevel::dimension;
+
+    static const int numFaces = 2*dimension;
+
+    typedef FieldVector< ctype, dimension > GlobalVector;
+    typedef FieldVector< ctype, dimension > LocalVector;
+
+    typedef typename GeometricGridLevel::template Codim< 0 >::GeometryCache GeometryCache;
+    typedef typename GeometryCache::JacobianTransposed JacobianTransposed;
+    typedef typename GeometryCache::JacobianInverseTransposed JacobianInverseTransposed;
+
+    typedef Dune::QuadratureRule< ctype, dimension > QuadratureRule;
+
+    SPUniformGeometry ( const GeometricGridLevel &gridLevel, const QuadratureRule &quadrature );
+
+    /** \brief number of quadrature points */
+    std::size_t size () const { return points_.size(); }
+
+    /** \brief local coordinate of a quadrature point */
+    const LocalVector &point ( std::size_t qp ) const { assert( qp < size() ); return points_[ qp ]; }
+
+    /** \brief quadrature weight times integration element */
+    ctype weight ( std::size_t qp ) const { assert( qp < size() ); return weights_[ qp ]; }
+
+    /** \brief integration weights of all quadrature points */
+    const std::vector< ctype > &weights () const { return weights_; }
+
+    /**
+     * \brief weighted metric for gradients at a quadrature point
+     *
+     * The i-th component is <tt>weight( qp ) * gradientScale()[ i ]^2</tt>,
+     * so that the contribution of a quadrature point to
+     * <tt>grad u * grad v</tt> is the sum of
+     * <tt>gradientWeight( qp )[ i ] * du_i * dv_i</tt> over the local
+     * derivatives.
+     */
+    const GlobalVector &gradientWeight ( std::size_t qp ) const { assert( qp < size() ); return gradientWeights_[ qp ]; }
+
+    /** \brief diagonal of the inverse transposed Jacobian (global gradient = gradientScale() * local gradient, componentwise) */
+    const GlobalVector &gradientScale () const { return gradientScale_; }
+
+    const JacobianTransposed &jacobianTransposed () const { return jacobianTransposed_; }
+    const JacobianInverseTransposed &jacobianInverseTransposed () const { return jacobianInverseTransposed_; }
+
+    /** \brief integration element, i.e., the volume of an element */
+    ctype integrationElement () const { return volume_; }
+    ctype volume () const { return volume_; }
+
+    /** \brief unit outer normal of a face times its volume */
+    const GlobalVector &integrationOuterNormal ( int face ) const { assert( (face >= 0) && (face < numFaces) ); return integrationOuterNormals_[ face ]; }
+
+    ctype faceVolume ( int face ) const { assert( (face >= 0) && (face < numFaces) ); return faceVolumes_[ face ]; }
+
+  private:
+    std::vector< LocalVector > points_;
+    std::vector< ctype > weights_;
+    std::vector< GlobalVector > gradientWeights_;
+    GlobalVector gradientScale_;
+    JacobianTransposed jacobianTransposed_;
+    JacobianInverseTransposed jacobianInverseTransposed_;
+    ctype volume_;
+    std::array< GlobalVector, numFaces > integrationOuterNormals_;
+    std::array< ctype, numFaces > faceVolumes_;
+  };
+
+
+
+  // Implementation of SPUniformGeometry
+  // -----------------------------------
+
+  template< class ct, int dim >
+  inline SPUniformGeometry< ct, dim >
+    ::SPUniformGeometry ( const GeometricGridLevel &gridLevel, const QuadratureRule &quadrature )
+  {
+    const GeometryCache &cache = gridLevel.geometryCache( Dune::Codim< 0 >() );
+    jacobianTransposed_ = cache.jacobianTransposed();
+    jacobianInverseTransposed_ = cache.jacobianInverseTransposed();
+    volume_ = cache.volume();
+
+    for( int i = 0; i < dimension; ++i )
+      gradientScale_[ i ] = ctype( 1 ) / gridLevel.h()[ i ];
+
+    points_.reserve( quadrature.size() );
+    weights_.reserve( quadrature.size() );
+    gradientWeights_.reserve( quadrature.size() );
+    for( const auto &qp : quadrature )
+    {
+      points_.push_back( qp.position() );
+      weights_.push_back( qp.weight() * volume_ );
+
+      GlobalVector gradientWeight;
+      for( int i = 0; i < dimension; ++i )
+        gradientWeight[ i ] = weights_.back() * gradientScale_[ i ] * gradientScale_[ i ];
+      gradientWeights_.push_back( gradientWeight );
+    }
+
+    for( int face = 0; face < numFaces; ++face )
+    {
+      faceVolumes_[ face ] = gridLevel.faceVolume( face );
+      const SPNormalVector< ctype, dimension > normal = SPNormalId< dimension >( face );
+      integrationOuterNormals_[ face ] = static_cast< GlobalVector >( normal );
+      integrationOuterNormals_[ face ] *= faceVolumes_[ face ];
+    }
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_UNIFORMGEOMETRY_HH
@@ -0,0 +1,318 @@
+#ifndef DUNE_SPGRID_VECTORCOMMUNICATION_HH
+#define DUNE_SPGRID_VECTORCOMMUNICATION_HH
+
+#include <cassert>
+#include <cstddef>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hybridutilities.hh>
+
+#include <dune/grid/common/exceptions.hh>
+#include <dune/grid/common/gridenums.hh>
+
+#include <dune/grid/spgrid/communication.hh>
+#include <dune/grid/spgrid/indexset.hh>
+#include <dune/grid/spgrid/lineiterator.hh>
+#include <dune/grid/spgrid/messagebuffer.hh>
+
+/** \file
+ *  \author Martin Nolte
+ *  \brief  communication of vectors indexed by an SPIndexSet
+ */
+
+namespace Dune
+{
+
+  namespace __SPGrid
+  {
+
+    // forEachLine
+    // -----------
+
+    template< class Grid, class F >
+    inline void forEachLine ( const SPIndexSet< const Grid > &indexSet, const SPPartitionList< Grid::dimension > &partitionList, int codim, F &&f )
+    {
+      Hybrid::forEach( std::make_integer_sequence< int, Grid::dimension+1 >(), [ &indexSet, &partitionList, codim, &f ] ( auto cd ) {
+          typedef SPLineIterator< cd, const Grid > LineIterator;
+
+          if( cd != codim )
+            return;
+
+          const LineIterator end( indexSet, partitionList, typename LineIterator::End() );
+          for( LineIterator it( indexSet, partitionList, typename LineIterator::Begin() ); it != end; ++it )
+            f( *it );
+        } );
+    }
+
+
+
+    // packLine
+    // --------
+
+    /** \brief write blockSize values for each of size entities, starting at values, copying the whole line if it is contiguous */
+    template< class T, class Buffer >
+    inline void packLine ( const T *values, std::size_t size, std::size_t stride, std::size_t blockSize, Buffer &buffer )
+    {
+      if( stride == 1 )
+        buffer.write( values, size * blockSize );
+      else
+      {
+        for( std::size_t i = 0; i < size; ++i )
+          buffer.write( values + i * stride * blockSize, blockSize );
+      }
+    }
+
+
+
+    // unpackLine
+    // ----------
+
+    /** \brief read blockSize values for each of size entities, starting at values, copying the whole line if it is contiguous */
+    template< class T, class Buffer >
+    inline void unpackLine ( T *values, std::size_t size, std::size_t stride, std::size_t blockSize, Buffer &buffer )
+    {
+      if( stride == 1 )
+        buffer.read( values, size * blockSize );
+      else
+      {
+        for( std::size_t i = 0; i < size; ++i )
+          buffer.read( values + i * stride * blockSize, blockSize );
+      }
+    }
+
+
+
+    // packLines
+    // ---------
+
+    /** \brief write blockSize values for each entity of the partition list, copying whole lines where possible */
+    template< class Grid, class T, class Buffer >
+    inline void packLines ( const SPIndexSet< const Grid > &indexSet, const SPPartitionList< Grid::dimension > &partitionList,
+                            int codim, const T *data, std::size_t blockSize, Buffer &buffer )
+    {
+      forEachLine( indexSet, partitionList, codim, [ data, blockSize, &buffer ] ( const auto &line ) {
+          packLine( data + std::size_t( line.index() ) * blockSize, std::size_t( line.size() ), std::size_t( line.stride() ), blockSize, buffer );
+        } );
+    }
+
+
+
+    // unpackLines
+    // -----------
+
+    /** \brief read blockSize values for each entity of the partition list, copying whole lines where possible */
+    template< class Grid, class T, class Buffer >
+    inline void unpackLines ( const SPIndexSet< const Grid > &indexSet, const SPPartitionList< Grid::dimension > &partitionList,
+                              int codim, T *data, std::size_t blockSize, Buffer &buffer )
+    {
+      forEachLine( indexSet, partitionList, codim, [ data, blockSize, &buffer ] ( const auto &line ) {
+          unpackLine( data + std::size_t( line.index() ) * blockSize, std::size_t( line.size() ), std::size_t( line.stride() ), blockSize, buffer );
+        } );
+    }
+
+  } // namespace __SPGrid
+
+
+
+  // SPBasicVectorCommunication
+  // --------------------------
+
+  /**
+   * \brief common base of the vector communications with a fixed shape
+   *
+   * Stores the index set, interface, codimension, direction and block size
+   * and provides the size checks shared by SPVectorCommunication,
+   * SPDatatypeCommunication, SPNeighborhoodCommunication and
+   * SPSharedMemoryCommunication.
+   */
+  template< class Grid, class T >
+  class SPBasicVectorCommunication
+  {
+    typedef SPBasicVectorCommunication< Grid, T > This;
+
+    static_assert( std::is_trivially_copyable< T >::value, "Vector communication requires trivially copyable values." );
+
+  public:
+    static const int dimension = Grid::dimension;
+
+    typedef SPIndexSet< const Grid > IndexSet;
+    typedef typename IndexSet::GridLevel GridLevel;
+    typedef typename GridLevel::CommInterface Interface;
+    typedef typename GridLevel::PartitionList PartitionList;
+
+    typedef T DataType;
+
+    SPBasicVectorCommunication ( const IndexSet &indexSet, int codim, InterfaceType iftype, CommunicationDirection dir, int blockSize )
+      : indexSet_( indexSet ), interface_( indexSet.gridLevel().commInterface( iftype ) ), codim_( codim ), dir_( dir ), blockSize_( blockSize )
+    {
+      assert( (codim >= 0) && (codim <= dimension) && (blockSize > 0) );
+      if( indexSet.partitionOrdering() )
+        DUNE_THROW( NotImplemented, "Vector communication requires lexicographic ordering (got " << indexSet.ordering().name() << ")." );
+    }
+
+    const IndexSet &indexSet () const { return indexSet_; }
+
+    int codimension () const { return codim_; }
+
+    /** \brief number of values stored per entity */
+    int blockSize () const { return blockSize_; }
+
+  protected:
+    void checkSize ( const std::vector< T > &data ) const
+    {
+      if( data.size() < std::size_t( indexSet().size( codimension() ) ) * std::size_t( blockSize() ) )
+        DUNE_THROW( RangeError, "Vector too small for communication (size: " << data.size() << ")." );
+    }
+
+    /** \brief size of the message for a partition list in bytes */
+    std::size_t messageSize ( const PartitionList &partitionList ) const
+    {
+      return partitionList.volume( codimension() ) * std::size_t( blockSize() ) * sizeof( T );
+    }
+
+    const IndexSet &indexSet_;
+    const Interface &interface_;
+    int codim_;
+    CommunicationDirection dir_;
+    int blockSize_;
+  };
+
+
+
+  // SPVectorCommunication
+  // ---------------------
+
+  /**
+   * \class SPVectorCommunication
+   * \brief communication of a vector indexed by an SPIndexSet
+   *
+   * The vector holds blockSize consecutive values for each entity of one
+   * codimension. Instead of calling a data handle for each entity, the values
+   * are packed and unpacked along the lines of the send and receive lists
+   * (see SPLineIterator), copying a whole line at once.
+   *
+   * The message sizes are known in advance, so the receives are posted on
+   * construction and the data are unpacked in wait (or on destruction).
+   *
+   * \note The value type must be trivially copyable and the index set must
+   *       not use a space-filling curve ordering. The vector must not be
+   *       reallocated while a communication is in progress.
+   */
+  template< class Grid, class T >
+  class SPVectorCommunication
+    : public SPBasicVectorCommunication< Grid, T >
+  {
+    typedef SPVectorCommunication< Grid, T > This;
+    typedef SPBasicVectorCommunication< Grid, T > Base;
+
+  public:
+    typedef typename Base::IndexSet IndexSet;
+    typedef typename Base::Interface Interface;
+
+  private:
+    typedef SPPackedMessageWriteBuffer< typename Grid::Communication > WriteBuffer;
+    typedef SPPackedMessageReadBuffer< typename Grid::Communication > ReadBuffer;
+
+  public:
+    SPVectorCommunication ( const IndexSet &indexSet, std::vector< T > &data, int codim, int blockSize,
+                            InterfaceType iftype, CommunicationDirection dir );
+
+    SPVectorCommunication ( const This & ) = delete;
+    SPVectorCommunication ( This &&other );
+
+    ~SPVectorCommunication () { wait(); }
+
+    This &operator= ( const This & ) = delete;
+
+    bool ready () const { return !active_; }
+
+    void wait ();
+
+  private:
+    std::vector< T > &data_;
+    bool active_;
+    SPCommTag tag_;
+    std::vector< WriteBuffer > writeBuffers_;
+    std::vector< ReadBuffer > readBuffers_;
+  };
+
+
+
+  // Implementation of SPVectorCommunication
+  // ---------------------------------------
+
+  template< class Grid, class T >
+  inline SPVectorCommunication< Grid, T >
+    ::SPVectorCommunication ( const IndexSet &indexSet, std::vector< T > &data, int codim, int blockSize,
+                              InterfaceType iftype, CommunicationDirection dir )
+    : Base( indexSet, codim, iftype, dir, blockSize ),
+      data_( data ),
+      active_( true ),
+      tag_( indexSet.gridLevel().grid().tagAllocator() )
+  {
+    this->checkSize( data );
+
+    const auto &comm = indexSet.gridLevel().grid().messageComm();
+    SPMessageBufferPool &pool = indexSet.gridLevel().bufferPool();
+    const std::size_t numLinks = this->interface_.size();
+
+    readBuffers_.reserve( numLinks );
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      readBuffers_.emplace_back( comm, pool );
+      readBuffers_.back().receive( it->rank(), tag_, this->messageSize( it->receiveList( dir ) ) );
+    }
+
+    writeBuffers_.reserve( numLinks );
+    for( typename Interface::Iterator it = this->interface_.begin(); it != this->interface_.end(); ++it )
+    {
+      writeBuffers_.emplace_back( comm, pool, it->rank() );
+      __SPGrid::packLines( this->indexSet(), it->sendList( dir ), this->codimension(), data_.data(), this->blockSize(), writeBuffers_.back() );
+      writeBuffers_.back().send( it->rank(), tag_ );
+    }
+  }
+
+
+  template< class Grid, class T >
+  inline SPVectorCommunication< Grid, T >::SPVectorCommunication ( This &&other )
+    : Base( other ),
+      data_( other.data_ ),
+      active_( other.active_ ),
+      tag_( std::move( other.tag_ ) ),
+      writeBuffers_( std::move( other.writeBuffers_ ) ),
+      readBuffers_( std::move( other.readBuffers_ ) )
+  {
+    other.active_ = false;
+  }
+
+
+  template< class Grid, class T >
+  inline void SPVectorCommunication< Grid, T >::wait ()
+  {
+    if( ready() )
+      return;
+
+    for( std::size_t i = 0; i < this->interface_.size(); ++i )
+    {
+      const typename std::vector< ReadBuffer >::iterator buffer = waitAny( readBuffers_ );
+      const typename Interface::Iterator it = std::next( this->interface_.begin(), buffer - readBuffers_.begin() );
+      __SPGrid::unpackLines( this->indexSet(), it->receiveList( this->dir_ ), this->codimension(), data_.data(), this->blockSize(), *buffer );
+    }
+    readBuffers_.clear();
+
+    for( WriteBuffer &buffer : writeBuffers_ )
+      buffer.wait();
+    writeBuffers_.clear();
+
+    tag_.release();
+    active_ = false;
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_VECTORCOMMUNICATION_HH
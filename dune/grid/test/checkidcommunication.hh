@@ -1,6 +1,8 @@
 #ifndef DUNE_SPGRID_CHECKIDCOMMUNICATION_HH
 #define DUNE_SPGRID_CHECKIDCOMMUNICATION_HH
 
+#include <algorithm>
+
 #include <dune/common/hybridutilities.hh>
 
 #include <dune/geometry/dimension.hh>
@@ -21,12 +23,57 @@ namespace Dune
     std::cout << "Checking communication ids for " << iftype << "..." << std::endl;
     CheckIdCommunicationDataHandle< VT > handle( gridView );
     gridView.communicate( handle, iftype, Dune::ForwardCommunication );
+
+    std::cout << "Checking communication plan for " << iftype << "..." << std::endl;
+    auto plan = gridView.impl().communicationPlan( handle, iftype, Dune::ForwardCommunication );
+    for( int i = 0; i < 2; ++i )
+      plan.exchange();
+
+    std::cout << "Checking polled communication for " << iftype << "..." << std::endl;
+    auto communication = gridView.impl().communicate( handle, iftype, Dune::ForwardCommunication );
+    communication.startProgress();
+    while( !communication.test() )
+      continue;
+    if( !communication.ready() )
+      DUNE_THROW( GridError, "Communication not ready after successful test." );
+    if( gridView.grid().progressThread().active() )
+      DUNE_THROW( GridError, "Completed communication still drives the progress thread." );
+  }
+
+
+  template< class VT >
+  inline void checkPersistentTag ( const GridView< VT > &gridView )
+  {
+    std::cout << "Checking message tags while a communication plan is alive..." << std::endl;
+
+    // the persistent tag must not block the cycle of transient tags
+    SPTagAllocator allocator( 0, 255 );
+    SPCommTag persistent( allocator, SPTagAllocator::persistent );
+    for( int i = 0; i < 4*256; ++i )
+    {
+      SPCommTag tag( allocator );
+      if( tag == persistent )
+        DUNE_THROW( GridError, "Transient tag " << int( tag ) << " collides with persistent tag." );
+    }
+
+    CheckIdCommunicationDataHandle< VT > handle( gridView );
+    auto plan = gridView.impl().communicationPlan( handle, InteriorBorder_All_Interface, Dune::ForwardCommunication );
+
+    // more than maxTag allocations in serial, bounded for large MPI tag ranges
+    SPTagAllocator &gridAllocator = gridView.grid().tagAllocator();
+    const long n = std::min( long( gridAllocator.maxTag() ) + 1, 1l << 16 );
+    for( long i = 0; i < n; ++i )
+      SPCommTag tag( gridAllocator );
+
+    plan.exchange();
+    gridView.communicate( handle, InteriorBorder_All_Interface, Dune::ForwardCommunication );
   }
 
 
   template< class VT >
   inline void checkIdCommunication ( const GridView< VT > &gridView )
   {
+    checkPersistentTag( gridView );
     checkIdCommunication< InteriorBorder_InteriorBorder_Interface >( gridView );
     checkIdCommunication< InteriorBorder_All_Interface >( gridView );
     checkIdCommunication< Overlap_OverlapFront_Interface >( gridView );
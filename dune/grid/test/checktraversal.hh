@@ -0,0 +1,412 @@
+#ifndef DUNE_SPGRID_CHECKTRAVERSAL_HH
+#define DUNE_SPGRID_CHECKTRAVERSAL_HH
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dune/common/exceptions.hh>
+#include <dune/common/hybridutilities.hh>
+
+#include <dune/grid/common/gridview.hh>
+#include <dune/grid/common/rangegenerators.hh>
+
+#include <dune/grid/spgrid/foreach.hh>
+#include <dune/grid/spgrid/ordering.hh>
+#include <dune/grid/spgrid/parallel.hh>
+
+namespace Dune
+{
+
+  // checkTiledTraversal
+  // -------------------
+
+  template< class VT >
+  inline void checkTiledTraversal ( const GridView< VT > &gridView )
+  {
+    typedef typename GridView< VT >::Implementation::MultiIndex MultiIndex;
+
+    static const int dimension = GridView< VT >::dimension;
+
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &gridView ] ( auto codim ) {
+        std::cout << ">>> Checking tiled traversal for codimension " << codim << "..." << std::endl;
+
+        MultiIndex tileSize;
+        for( int i = 0; i < dimension; ++i )
+          tileSize[ i ] = 2 + (i % 2);
+
+        const unsigned int numDirections = (1u << dimension);
+        for( unsigned int sweepDir = 0; sweepDir < numDirections; ++sweepDir )
+        {
+          std::vector< int > count( gridView.size( codim ), 0 );
+
+          const auto end = gridView.impl().template end< codim >( sweepDir );
+          for( auto it = gridView.impl().template begin< codim >( tileSize, sweepDir ); it != end; ++it )
+            ++count[ gridView.indexSet().index( *it ) ];
+
+          for( std::size_t i = 0; i < count.size(); ++i )
+          {
+            if( count[ i ] != 1 )
+              DUNE_THROW( Exception, "Tiled traversal visited entity " << i << " " << count[ i ] << " times (sweep direction " << sweepDir << ")." );
+          }
+        }
+      } );
+  }
+
+
+
+  // checkLineTraversal
+  // ------------------
+
+  template< class VT >
+  inline void checkLineTraversal ( const GridView< VT > &gridView )
+  {
+    static const int dimension = GridView< VT >::dimension;
+
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &gridView ] ( auto codim ) {
+        std::cout << ">>> Checking line traversal for codimension " << codim << "..." << std::endl;
+
+        // flattening the lines has to reproduce the default traversal
+        auto it = gridView.template begin< codim, Interior_Partition >();
+        const auto end = gridView.template end< codim, Interior_Partition >();
+
+        const auto lend = gridView.impl().template lineEnd< codim, Interior_Partition >();
+        for( auto lit = gridView.impl().template lineBegin< codim, Interior_Partition >(); lit != lend; ++lit )
+        {
+          for( std::size_t i = 0; i < lit->size(); ++i, ++it )
+          {
+            if( it == end )
+              DUNE_THROW( Exception, "Line traversal visits more entities than the default traversal." );
+            if( gridView.indexSet().index( *it ) != lit->index( i ) )
+              DUNE_THROW( Exception, "Line traversal yields index " << lit->index( i ) << " instead of " << gridView.indexSet().index( *it ) << "." );
+            if( it->impl().entityInfo().id() != lit->id( i ) )
+              DUNE_THROW( Exception, "Line traversal yields multi index " << lit->id( i ) << " instead of " << it->impl().entityInfo().id() << "." );
+          }
+        }
+        if( it != end )
+          DUNE_THROW( Exception, "Line traversal visits less entities than the default traversal." );
+      } );
+  }
+
+
+
+  // checkParallelTraversal
+  // ----------------------
+
+  template< class VT >
+  inline void checkParallelTraversal ( const GridView< VT > &gridView )
+  {
+    static const int dimension = GridView< VT >::dimension;
+
+    SPThreadPool pool( 3 );
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &gridView, &pool ] ( auto codim ) {
+        std::cout << ">>> Checking parallel traversal for codimension " << codim << "..." << std::endl;
+
+        std::vector< std::atomic< int > > count( gridView.size( codim ) );
+        for( auto &c : count )
+          c = 0;
+
+        parallelForEach( gridView, Codim< codim >(), [ &gridView, &count ] ( const auto &entity ) {
+            ++count[ gridView.indexSet().index( entity ) ];
+          }, pool );
+
+        for( std::size_t i = 0; i < count.size(); ++i )
+        {
+          if( count[ i ] != 1 )
+            DUNE_THROW( Exception, "Parallel traversal visited entity " << i << " " << count[ i ] << " times." );
+        }
+      } );
+
+    std::cout << ">>> Checking nested parallel traversal..." << std::endl;
+    std::vector< std::atomic< int > > count( gridView.size( 0 ) );
+    for( auto &c : count )
+      c = 0;
+
+    // nested calls to a busy pool are executed inline
+    std::vector< SPThreadPool::Task > tasks;
+    for( unsigned int i = 0; i < pool.size(); ++i )
+    {
+      tasks.emplace_back( [ &gridView, &count, &pool ] () {
+          parallelForEach( gridView, Codim< 0 >(), [ &gridView, &count ] ( const auto &entity ) {
+              ++count[ gridView.indexSet().index( entity ) ];
+            }, pool );
+        } );
+    }
+    pool.execute( std::move( tasks ) );
+
+    for( std::size_t i = 0; i < count.size(); ++i )
+    {
+      if( count[ i ] != int( pool.size() ) )
+        DUNE_THROW( Exception, "Nested parallel traversal visited entity " << i << " " << count[ i ] << " times." );
+    }
+  }
+
+
+
+  // checkColoredTraversal
+  // ---------------------
+
+  template< class VT >
+  inline void checkColoredTraversal ( const GridView< VT > &gridView )
+  {
+    typedef typename GridView< VT >::Implementation::template Codim< 0 >::IteratorImpl IteratorImpl;
+
+    static const int dimension = GridView< VT >::dimension;
+
+    std::cout << ">>> Checking colored traversal..." << std::endl;
+
+    const auto &gridLevel = gridView.impl().gridLevel();
+    const auto &indexSet = gridView.indexSet();
+
+    // cells of one color must not share vertices
+    std::vector< int > count( gridView.size( 0 ), 0 );
+    for( unsigned int color = 0; color < IteratorImpl::numColors; ++color )
+    {
+      std::vector< int > vertexCount( gridView.size( dimension ), 0 );
+
+      const typename GridView< VT >::template Codim< 0 >::Iterator end
+        = IteratorImpl( gridLevel, gridLevel.template partition< All_Partition >(), typename IteratorImpl::End() );
+      typename GridView< VT >::template Codim< 0 >::Iterator it
+        = IteratorImpl( gridLevel, gridLevel.template partition< All_Partition >(), typename IteratorImpl::Begin(), typename IteratorImpl::Color( color ) );
+      for( ; it != end; ++it )
+      {
+        ++count[ indexSet.index( *it ) ];
+        for( unsigned int i = 0; i < it->subEntities( dimension ); ++i )
+        {
+          if( ++vertexCount[ indexSet.subIndex( *it, i, dimension ) ] > 1 )
+            DUNE_THROW( Exception, "Cells of color " << color << " share a vertex." );
+        }
+      }
+    }
+
+    for( std::size_t i = 0; i < count.size(); ++i )
+    {
+      if( count[ i ] != 1 )
+        DUNE_THROW( Exception, "Colored traversal visited cell " << i << " " << count[ i ] << " times." );
+    }
+
+    // parallel colored traversal
+    SPThreadPool pool( 3 );
+    std::vector< std::atomic< int > > parallelCount( gridView.size( 0 ) );
+    for( auto &c : parallelCount )
+      c = 0;
+    parallelForEachColored( gridView, Codim< 0 >(), [ &indexSet, &parallelCount ] ( const auto &entity ) {
+        ++parallelCount[ indexSet.index( entity ) ];
+      }, pool );
+    for( std::size_t i = 0; i < parallelCount.size(); ++i )
+    {
+      if( parallelCount[ i ] != 1 )
+        DUNE_THROW( Exception, "Parallel colored traversal visited cell " << i << " " << parallelCount[ i ] << " times." );
+    }
+  }
+
+
+
+  // checkWavefrontTraversal
+  // -----------------------
+
+  template< class VT >
+  inline void checkWavefrontTraversal ( const GridView< VT > &gridView )
+  {
+    static const int dimension = GridView< VT >::dimension;
+
+    std::cout << ">>> Checking wavefront traversal..." << std::endl;
+
+    const auto &indexSet = gridView.indexSet();
+
+    SPMultiIndex< dimension > blockSize;
+    for( int i = 0; i < dimension; ++i )
+      blockSize[ i ] = 2 + (i % 2);
+
+    SPThreadPool pool( 3 );
+    const unsigned int numDirections = (1u << dimension);
+    for( unsigned int sweepDir = 0; sweepDir < numDirections; ++sweepDir )
+    {
+      // sequential sweep
+      std::vector< int > sequential( gridView.size( 0 ), -1 );
+      int count = 0;
+      const auto end = gridView.impl().template end< 0 >( sweepDir );
+      for( auto it = gridView.impl().template begin< 0 >( sweepDir ); it != end; ++it )
+        sequential[ indexSet.index( *it ) ] = count++;
+
+      // parallel wavefront sweep
+      std::atomic< int > counter( 0 );
+      std::vector< std::atomic< int > > order( gridView.size( 0 ) );
+      for( auto &o : order )
+        o = -1;
+      parallelForEachWavefront( gridView, Codim< 0 >(), [ &indexSet, &counter, &order ] ( const auto &entity ) {
+          if( order[ indexSet.index( entity ) ].exchange( counter++ ) != -1 )
+            DUNE_THROW( Exception, "Wavefront traversal visited an entity twice." );
+        }, sweepDir, blockSize, pool );
+
+      // face neighbors have to be visited in sequential order
+      for( const auto &element : elements( gridView ) )
+      {
+        const int index = indexSet.index( element );
+        if( order[ index ] < 0 )
+          DUNE_THROW( Exception, "Wavefront traversal did not visit element " << index << "." );
+        for( const auto &intersection : intersections( gridView, element ) )
+        {
+          if( !intersection.neighbor() )
+            continue;
+          const int nbIndex = indexSet.index( intersection.outside() );
+          if( (sequential[ nbIndex ] < sequential[ index ]) != (order[ nbIndex ] < order[ index ]) )
+            DUNE_THROW( Exception, "Wavefront traversal changes the order of neighbors " << nbIndex << " and " << index << " (sweep direction " << sweepDir << ")." );
+        }
+      }
+    }
+  }
+
+
+
+  // checkDeepInteriorTraversal
+  // --------------------------
+
+  template< class VT >
+  inline void checkDeepInteriorTraversal ( const GridView< VT > &gridView )
+  {
+    static const int dimension = GridView< VT >::dimension;
+
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &gridView ] ( auto codim ) {
+        std::cout << ">>> Checking deep interior and shell for codimension " << codim << "..." << std::endl;
+
+        const auto &indexSet = gridView.indexSet();
+        std::vector< int > count( gridView.size( codim ), 0 );
+
+        const auto dend = gridView.impl().template deepInteriorEnd< codim >();
+        for( auto it = gridView.impl().template deepInteriorBegin< codim >(); it != dend; ++it )
+        {
+          ++count[ indexSet.index( *it ) ];
+          if( it->partitionType() != InteriorEntity )
+            DUNE_THROW( Exception, "Deep interior contains non-interior entity." );
+        }
+
+        const auto send = gridView.impl().template shellEnd< codim >();
+        for( auto it = gridView.impl().template shellBegin< codim >(); it != send; ++it )
+          ++count[ indexSet.index( *it ) ];
+
+        for( const auto &entity : entities( gridView, Codim< codim >(), Partitions::interiorBorder ) )
+        {
+          if( count[ indexSet.index( entity ) ] != 1 )
+            DUNE_THROW( Exception, "Deep interior and shell contain interior border entity " << indexSet.index( entity ) << " " << count[ indexSet.index( entity ) ] << " times." );
+          count[ indexSet.index( entity ) ] = 0;
+        }
+        for( std::size_t i = 0; i < count.size(); ++i )
+        {
+          if( count[ i ] != 0 )
+            DUNE_THROW( Exception, "Deep interior or shell contains entity " << i << " outside the interior border partition." );
+        }
+      } );
+
+    // cells of the deep interior must not have overlap neighbors
+    const auto end = gridView.impl().template deepInteriorEnd< 0 >();
+    for( auto it = gridView.impl().template deepInteriorBegin< 0 >(); it != end; ++it )
+    {
+      for( const auto &intersection : intersections( gridView, *it ) )
+      {
+        if( intersection.neighbor() && (intersection.outside().partitionType() != InteriorEntity) )
+          DUNE_THROW( Exception, "Deep interior cell has a neighbor outside the interior." );
+      }
+    }
+  }
+
+
+
+  // checkForEachEntity
+  // ------------------
+
+  template< class VT >
+  inline void checkForEachEntity ( const GridView< VT > &gridView )
+  {
+    static const int dimension = GridView< VT >::dimension;
+
+    Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &gridView ] ( auto codim ) {
+        std::cout << ">>> Checking entity-free traversal for codimension " << codim << "..." << std::endl;
+
+        auto it = gridView.template begin< codim >();
+        const auto end = gridView.template end< codim >();
+        forEachEntity< codim >( gridView, [ &gridView, &it, &end ] ( const auto &id, auto index, const auto &center ) {
+            if( it == end )
+              DUNE_THROW( Exception, "forEachEntity visits more entities than the default traversal." );
+            if( id != it->impl().entityInfo().id() )
+              DUNE_THROW( Exception, "forEachEntity yields multi index " << id << " instead of " << it->impl().entityInfo().id() << "." );
+            if( index != gridView.indexSet().index( *it ) )
+              DUNE_THROW( Exception, "forEachEntity yields index " << index << " instead of " << gridView.indexSet().index( *it ) << "." );
+            auto diff = center;
+            diff -= it->geometry().center();
+            if( diff.two_norm() > 1e-8 )
+              DUNE_THROW( Exception, "forEachEntity yields wrong center " << center << " (should be " << it->geometry().center() << ")." );
+            ++it;
+          } );
+        if( it != end )
+          DUNE_THROW( Exception, "forEachEntity visits less entities than the default traversal." );
+
+        std::size_t count = 0;
+        forEachEntity< codim >( gridView, [ &count ] ( const auto &id, auto index ) { ++count; } );
+        if( count != std::size_t( gridView.size( codim ) ) )
+          DUNE_THROW( Exception, "forEachEntity without center visits " << count << " entities (size: " << gridView.size( codim ) << ")." );
+
+        typedef typename GridView< VT >::ctype ctype;
+        std::array< std::vector< ctype >, dimension > x;
+        std::array< ctype *, dimension > px;
+        for( int i = 0; i < dimension; ++i )
+        {
+          x[ i ].resize( gridView.size( codim ) );
+          px[ i ] = x[ i ].data();
+        }
+        fillCenters< codim >( gridView, px );
+        for( const auto &entity : entities( gridView, Codim< codim >() ) )
+        {
+          const auto index = gridView.indexSet().index( entity );
+          const auto center = entity.geometry().center();
+          for( int i = 0; i < dimension; ++i )
+          {
+            if( std::abs( x[ i ][ index ] - center[ i ] ) > 1e-8 )
+              DUNE_THROW( Exception, "fillCenters yields wrong coordinate " << x[ i ][ index ] << " (should be " << center[ i ] << ")." );
+          }
+        }
+      } );
+  }
+
+
+
+  // checkOrderedTraversal
+  // ---------------------
+
+  template< class VT >
+  inline void checkOrderedTraversal ( const GridView< VT > &gridView )
+  {
+    typedef typename GridView< VT >::Implementation::Ordering Ordering;
+
+    static const int dimension = GridView< VT >::dimension;
+
+    for( typename Ordering::Type type : { Ordering::morton, Ordering::hilbert } )
+    {
+      const Ordering ordering( type );
+      const auto view = gridView.impl().ordered( ordering );
+
+      Hybrid::forEach( std::make_integer_sequence< int, dimension+1 >(), [ &view, &ordering ] ( auto codim ) {
+          std::cout << ">>> Checking " << ordering.name() << " traversal for codimension " << codim << "..." << std::endl;
+
+          // entities are numbered in traversal order
+          std::size_t count = 0;
+          const auto end = view.template end< codim >();
+          for( auto it = view.template begin< codim >(); it != end; ++it, ++count )
+          {
+            const std::size_t index = view.indexSet().index( *it );
+            if( index != count )
+              DUNE_THROW( Exception, "Entity " << count << " in " << ordering.name() << " traversal has index " << index << "." );
+            if( view.indexSet().multiIndex( codim, index ).first != it.impl().entityInfo().id() )
+              DUNE_THROW( Exception, "Inverse " << ordering.name() << " index map yields wrong multi index." );
+          }
+          if( count != std::size_t( view.size( codim ) ) )
+            DUNE_THROW( Exception, ordering.name() << " traversal visited " << count << " entities (size: " << view.size( codim ) << ")." );
+        } );
+    }
+  }
+
+} // namespace Dune
+
+#endif // #ifndef DUNE_SPGRID_CHECKTRAVERSAL_HH
@@ -4,15 +4,30 @@
 #error "DIMGRID not defined. Please compile with -DDIMGRID=n"
 #endif
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
 #include <type_traits>
+#include <vector>
 
 #include <dune/common/hybridutilities.hh>
 #include <dune/common/parallel/mpihelper.hh>
 
+#include <dune/geometry/quadraturerules.hh>
+
 #include <dune/grid/common/rangegenerators.hh>
 
 #include <dune/grid/spgrid.hh>
+#include <dune/grid/spgrid/datatypecommunication.hh>
 #include <dune/grid/spgrid/dgfparser.hh>
+#include <dune/grid/spgrid/fusedcommunication.hh>
+#include <dune/grid/spgrid/levelcontainer.hh>
+#include <dune/grid/spgrid/neighborhoodcommunication.hh>
+#include <dune/grid/spgrid/sharedmemorycommunication.hh>
 
 #include <dune/grid/test/gridcheck.hh>
 #include <dune/grid/test/checkintersectionit.hh>
@@ -23,10 +38,17 @@
 
 #include <dune/grid/test/checkidcommunication.hh>
 #include <dune/grid/test/checkseiterator.hh>
+#include <dune/grid/test/checktraversal.hh>
 #include <dune/grid/test/checktree.hh>
 
 static const int dimGrid = DIMGRID;
 
+#if HAVE_MPI
+typedef MPI_Comm Comm;
+#else // #if HAVE_MPI
+typedef Dune::No_Comm Comm;
+#endif // #else // #if HAVE_MPI
+
 
 template< class GridView >
 void checkSubIndex ( const GridView &gridView )
@@ -53,6 +75,495 @@ void checkSubIndex ( const GridView &gridView )
 }
 
 
+template< class GridView >
+void checkIndexLayout ( const GridView &gridView )
+{
+  Dune::Hybrid::forEach( std::make_integer_sequence< int, GridView::dimension+1 >(), [ &gridView ] ( auto codim ) {
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking index layout for codim " << codim << "..." << std::endl;
+
+      static const int dimension = GridView::dimension;
+
+      const typename GridView::IndexSet &indexSet = gridView.indexSet();
+
+      for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+      {
+        const auto &entityInfo = entity.impl().entityInfo();
+        const auto &layout = indexSet.layout( entity );
+        if( layout.index( entityInfo.id() ) != indexSet.index( entity ) )
+          DUNE_THROW( Dune::GridError, "Index layout yields wrong index." );
+
+        if( codim != 0 )
+          continue;
+
+        // vertex indices are affine in the multi index
+        const auto &vertexLayout = indexSet.layout( entityInfo.partitionNumber(), 0u );
+        for( unsigned int i = 0; i < (1u << dimension); ++i )
+        {
+          auto id = entityInfo.id();
+          for( int j = 0; j < dimension; ++j )
+            id[ j ] += 2*int( (i >> j) & 1 ) - 1;
+          if( vertexLayout.index( id ) != indexSet.subIndex( entity, i, dimension ) )
+            DUNE_THROW( Dune::GridError, "Index layout yields wrong vertex index." );
+        }
+      }
+    } );
+}
+
+
+template< class GridView >
+void checkInverseIndex ( const GridView &gridView )
+{
+  Dune::Hybrid::forEach( std::make_integer_sequence< int, GridView::dimension+1 >(), [ &gridView ] ( auto codim ) {
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking inverse index map for codim " << codim << "..." << std::endl;
+
+      const typename GridView::IndexSet &indexSet = gridView.indexSet();
+
+      for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+      {
+        const auto &entityInfo = entity.impl().entityInfo();
+        const auto index = indexSet.index( entity );
+
+        const auto id = indexSet.multiIndex( codim, index );
+        if( (id.first != entityInfo.id()) || (id.second != entityInfo.partitionNumber()) )
+          DUNE_THROW( Dune::GridError, "Inverse index map yields wrong multi index." );
+
+        if( indexSet.index( gridView.grid().entity( indexSet.template seed< codim >( index ) ) ) != index )
+          DUNE_THROW( Dune::GridError, "Inverse index map yields wrong entity seed." );
+      }
+    } );
+}
+
+
+template< class GridView >
+void checkOwnedFirst ( const GridView &gridView )
+{
+  const GridView view( gridView.impl().ownedFirst() );
+
+  Dune::Hybrid::forEach( std::make_integer_sequence< int, GridView::dimension+1 >(), [ &view ] ( auto codim ) {
+      if( view.comm().rank() == 0 )
+        std::cerr << ">>> Checking owned-first numbering for codim " << codim << "..." << std::endl;
+
+      const typename GridView::IndexSet &indexSet = view.indexSet();
+      const std::size_t ownedSize = indexSet.ownedSize( codim );
+
+      // interior border entities form a prefix, all indices are used exactly once
+      std::vector< bool > visited( indexSet.size( codim ), false );
+      for( const auto &entity : entities( view, Dune::Codim< codim >() ) )
+      {
+        const std::size_t index = indexSet.index( entity );
+        if( (index >= visited.size()) || visited[ index ] )
+          DUNE_THROW( Dune::GridError, "Owned-first numbering is not consecutive." );
+        visited[ index ] = true;
+
+        const bool owned = (entity.partitionType() == Dune::InteriorEntity) || (entity.partitionType() == Dune::BorderEntity);
+        if( owned != (index < ownedSize) )
+          DUNE_THROW( Dune::GridError, "Owned-first numbering does not number interior border entities first." );
+
+        if( indexSet.multiIndex( codim, index ).first != entity.impl().entityInfo().id() )
+          DUNE_THROW( Dune::GridError, "Inverse owned-first index map yields wrong multi index." );
+      }
+
+      // lines are split at the boundary of the interior border entities
+      Dune::forEachEntity< codim >( view, [ &indexSet, codim ] ( const auto &id, auto index ) {
+          if( indexSet.multiIndex( codim, index ).first != id )
+            DUNE_THROW( Dune::GridError, "Line traversal yields wrong owned-first index." );
+        } );
+    } );
+}
+
+
+template< class Grid >
+void checkLocalIdSet ( const Grid &grid )
+{
+  const typename Grid::LocalIdSet &idSet = grid.localIdSet();
+
+  for( int level = 0; level <= grid.maxLevel(); ++level )
+  {
+    const auto gridView = grid.levelGridView( level );
+    Dune::Hybrid::forEach( std::make_integer_sequence< int, Grid::dimension+1 >(), [ &grid, &idSet, &gridView, level ] ( auto codim ) {
+        if( grid.comm().rank() == 0 )
+          std::cerr << ">>> Checking local ids on level " << level << " for codim " << codim << "..." << std::endl;
+
+        typedef typename Grid::template Codim< codim >::EntitySeed EntitySeed;
+
+        std::vector< typename Grid::LocalIdSet::IdType > ids;
+        idSet.ids( gridView.template begin< codim >(), gridView.template end< codim >(), std::back_inserter( ids ) );
+
+        std::size_t k = 0;
+        for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+        {
+          if( (k >= ids.size()) || (ids[ k++ ] != idSet.id( entity )) )
+            DUNE_THROW( Dune::GridError, "Batched id computation yields wrong id." );
+
+          // copies of coarser entities share the id of their father
+          const auto &entityInfo = entity.impl().entityInfo();
+          if( (level == 0) || !entityInfo.gridLevel().refinement().isCopy( entityInfo.id() ) )
+            continue;
+
+          auto fatherId = entityInfo.id();
+          entityInfo.gridLevel().refinement().father( fatherId );
+          const EntitySeed seed( typename EntitySeed::Implementation( level-1, fatherId, entityInfo.partitionNumber() ) );
+          if( idSet.id( grid.entity( seed ) ) != idSet.id( entity ) )
+            DUNE_THROW( Dune::GridError, "Copied entity does not share the id of its father." );
+        }
+      } );
+  }
+}
+
+
+template< class Grid, class VertexContainer, class CellContainer >
+void checkLevelContainer ( const Grid &grid, const VertexContainer &vertices, const CellContainer &cells )
+{
+  const int level = grid.maxLevel();
+  if( grid.comm().rank() == 0 )
+    std::cerr << ">>> Checking level container prolongation to level " << level << "..." << std::endl;
+
+  const auto gridView = grid.levelGridView( level );
+  for( const auto &vertex : Dune::vertices( gridView ) )
+  {
+    if( (vertices( vertex ) - vertex.geometry().center()).two_norm() > 1e-8 )
+      DUNE_THROW( Dune::GridError, "Linear prolongation does not reproduce vertex coordinates." );
+  }
+
+  for( const auto &element : Dune::elements( gridView ) )
+  {
+    if( cells( element ) != cells( element.father() ) )
+      DUNE_THROW( Dune::GridError, "Constant prolongation does not inherit value of father." );
+  }
+}
+
+
+template< class GridView >
+void checkUniformGeometry ( const GridView &gridView )
+{
+  typedef typename GridView::ctype ctype;
+
+  if( gridView.comm().rank() == 0 )
+    std::cerr << ">>> Checking uniform geometry..." << std::endl;
+
+  const auto &quadrature = Dune::QuadratureRules< ctype, GridView::dimension >::rule( Dune::GeometryTypes::cube( GridView::dimension ), 3 );
+  const auto uniform = gridView.impl().uniformGeometry( quadrature );
+  if( uniform.size() != quadrature.size() )
+    DUNE_THROW( Dune::GridError, "Uniform geometry has wrong number of quadrature points." );
+
+  for( const auto &element : elements( gridView ) )
+  {
+    const auto geometry = element.geometry();
+    ctype volume = 0;
+    for( std::size_t qp = 0; qp < uniform.size(); ++qp )
+    {
+      volume += uniform.weight( qp );
+      if( std::abs( uniform.weight( qp ) - quadrature[ qp ].weight() * geometry.integrationElement( uniform.point( qp ) ) ) > 1e-8 )
+        DUNE_THROW( Dune::GridError, "Uniform geometry yields wrong integration weight." );
+
+      const auto jit = static_cast< Dune::FieldMatrix< ctype, GridView::dimension, GridView::dimension > >( geometry.jacobianInverseTransposed( uniform.point( qp ) ) );
+      for( int i = 0; i < GridView::dimension; ++i )
+      {
+        if( std::abs( jit[ i ][ i ] - uniform.gradientScale()[ i ] ) > 1e-8 )
+          DUNE_THROW( Dune::GridError, "Uniform geometry yields wrong gradient scaling." );
+      }
+    }
+    if( std::abs( volume - geometry.volume() ) > 1e-8 )
+      DUNE_THROW( Dune::GridError, "Uniform geometry weights do not sum up to element volume." );
+
+    for( const auto &intersection : intersections( gridView, element ) )
+    {
+      auto diff = intersection.centerUnitOuterNormal();
+      diff *= intersection.geometry().volume();
+      diff -= uniform.integrationOuterNormal( intersection.indexInInside() );
+      if( diff.two_norm() > 1e-8 )
+        DUNE_THROW( Dune::GridError, "Uniform geometry yields wrong integration outer normal." );
+    }
+  }
+}
+
+
+template< class GridView >
+void checkVectorCommunication ( const GridView &gridView )
+{
+  typedef typename GridView::Grid Grid;
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+
+  const typename Grid::GlobalIdSet &idSet = gridView.grid().globalIdSet();
+
+  Dune::Hybrid::forEach( std::make_integer_sequence< int, GridView::dimension+1 >(), [ &gridView, &idSet ] ( auto codim ) {
+      // owned entities carry their id (twice), all other entities are marked as unknown
+      const IdType unknown = std::numeric_limits< IdType >::max();
+      auto initialize = [ &gridView, &idSet, unknown, codim ] ( std::vector< IdType > &data ) {
+          data.assign( 2*gridView.size( codim ), unknown );
+          for( const auto &entity : entities( gridView, Dune::Codim< codim >(), Dune::Partitions::interiorBorder ) )
+          {
+            const auto index = gridView.indexSet().index( entity );
+            data[ 2*index ] = data[ 2*index+1 ] = idSet.id( entity );
+          }
+        };
+
+      // every entity has an owner, so all entities must have received their id
+      auto check = [ &gridView, &idSet, codim ] ( const std::vector< IdType > &data ) {
+          for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+          {
+            const auto index = gridView.indexSet().index( entity );
+            for( int k = 0; k < 2; ++k )
+            {
+              if( data[ 2*index+k ] != idSet.id( entity ) )
+                DUNE_THROW( Dune::GridError, "Vector communication received wrong data." );
+            }
+          }
+        };
+
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking datatype communication for codim " << codim << "..." << std::endl;
+
+      std::vector< IdType > data;
+      initialize( data );
+      Dune::SPDatatypeCommunication< typename std::remove_const< Grid >::type, IdType > communication( gridView.indexSet(), codim, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication, 2 );
+      for( int i = 0; i < 2; ++i )
+        communication.exchange( data );
+      check( data );
+
+      // in these interfaces, received entities are also sent (or received more than once)
+      for( Dune::InterfaceType iftype : { Dune::InteriorBorder_InteriorBorder_Interface, Dune::All_All_Interface } )
+      {
+        if( gridView.comm().rank() == 0 )
+          std::cerr << ">>> Checking datatype communication on interface " << iftype << " for codim " << codim << "..." << std::endl;
+
+        // for All_All, every copy sends, so all copies must carry the same data
+        auto initializeFor = [ &gridView, &idSet, &initialize, iftype, codim ] ( std::vector< IdType > &data ) {
+            initialize( data );
+            if( iftype != Dune::All_All_Interface )
+              return;
+            for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+            {
+              const auto index = gridView.indexSet().index( entity );
+              data[ 2*index ] = data[ 2*index+1 ] = idSet.id( entity );
+            }
+          };
+
+        std::vector< IdType > overlapping, reference;
+        initializeFor( overlapping );
+        initializeFor( reference );
+        Dune::SPDatatypeCommunication< typename std::remove_const< Grid >::type, IdType > overlappingCommunication( gridView.indexSet(), codim, iftype, Dune::ForwardCommunication, 2 );
+        for( int i = 0; i < 2; ++i )
+          overlappingCommunication.exchange( overlapping );
+        gridView.impl().communicate( reference, codim, 2, iftype, Dune::ForwardCommunication ).wait();
+
+        for( const auto &entity : entities( gridView, Dune::Codim< codim >(), Dune::Partitions::interiorBorder ) )
+        {
+          const auto index = gridView.indexSet().index( entity );
+          if( (overlapping[ 2*index ] != idSet.id( entity )) || (overlapping[ 2*index+1 ] != idSet.id( entity )) )
+            DUNE_THROW( Dune::GridError, "Datatype communication corrupted data on interface " << iftype << "." );
+        }
+        if( overlapping != reference )
+          DUNE_THROW( Dune::GridError, "Packed and datatype vector communication differ on interface " << iftype << "." );
+      }
+
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking packed vector communication for codim " << codim << "..." << std::endl;
+
+      std::vector< IdType > packed;
+      initialize( packed );
+      gridView.impl().communicate( packed, codim, 2, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ).wait();
+      check( packed );
+      if( packed != data )
+        DUNE_THROW( Dune::GridError, "Packed and datatype vector communication differ." );
+
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking neighborhood vector communication for codim " << codim << "..." << std::endl;
+
+      std::vector< IdType > neighborhood;
+      initialize( neighborhood );
+      Dune::SPNeighborhoodCommunication< typename std::remove_const< Grid >::type, IdType > neighborhoodCommunication( gridView.indexSet(), codim, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication, 2 );
+      for( int i = 0; i < 2; ++i )
+        neighborhoodCommunication.exchange( neighborhood );
+      if( neighborhood != data )
+        DUNE_THROW( Dune::GridError, "Neighborhood and datatype vector communication differ." );
+
+      if( gridView.comm().rank() == 0 )
+        std::cerr << ">>> Checking shared memory vector communication for codim " << codim << "..." << std::endl;
+
+      std::vector< IdType > shared;
+      initialize( shared );
+      Dune::SPSharedMemoryCommunication< typename std::remove_const< Grid >::type, IdType > sharedCommunication( gridView.indexSet(), codim, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication, 2 );
+      for( int i = 0; i < 3; ++i )
+        sharedCommunication.exchange( shared );
+      if( shared != data )
+        DUNE_THROW( Dune::GridError, "Shared memory and datatype vector communication differ." );
+
+      // repeating the communication must reuse the pooled message buffers
+      const Dune::SPMessageBufferPool &pool = gridView.impl().gridLevel().bufferPool();
+      const std::size_t capacity = pool.capacity();
+      gridView.impl().communicate( packed, codim, 2, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ).wait();
+      check( packed );
+      if( pool.capacity() != capacity )
+        DUNE_THROW( Dune::GridError, "Repeated vector communication did not reuse message buffers." );
+    } );
+}
+
+
+template< class GridView >
+void checkConcurrentCommunication ( const GridView &gridView )
+{
+  typedef typename GridView::Grid Grid;
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+  typedef Dune::SPVectorCommunication< typename std::remove_const< Grid >::type, IdType > VectorCommunication;
+
+  const int codim = GridView::dimension;
+  const typename Grid::GlobalIdSet &idSet = gridView.grid().globalIdSet();
+  const IdType unknown = std::numeric_limits< IdType >::max();
+
+  // keep more communications in flight than fit into 8 bit of message tags
+  const std::size_t numFields = 300;
+  std::vector< std::vector< IdType > > fields( numFields, std::vector< IdType >( gridView.size( codim ), unknown ) );
+  for( const auto &entity : entities( gridView, Dune::Codim< codim >(), Dune::Partitions::interiorBorder ) )
+  {
+    for( std::size_t k = 0; k < numFields; ++k )
+      fields[ k ][ gridView.indexSet().index( entity ) ] = idSet.id( entity ) + IdType( k );
+  }
+
+  std::vector< VectorCommunication > communications;
+  communications.reserve( numFields );
+  for( std::size_t k = 0; k < numFields; ++k )
+    communications.push_back( gridView.impl().communicate( fields[ k ], codim, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ) );
+  for( VectorCommunication &communication : communications )
+    communication.wait();
+
+  if( gridView.grid().tagAllocator().inFlight() != 0u )
+    DUNE_THROW( Dune::GridError, "Completed communications still hold message tags." );
+
+  // the buffer pool must not retain the peak of concurrent communications
+  // (All_All links to every neighbor rank used by any interface)
+  const Dune::SPMessageBufferPool &pool = gridView.impl().gridLevel().bufferPool();
+  const std::size_t numLinks = gridView.impl().gridLevel().commInterface( Dune::All_All_Interface ).size();
+  if( pool.size() > 2*pool.maxFree()*numLinks )
+    DUNE_THROW( Dune::GridError, "Buffer pool retains " << pool.size() << " buffers for " << numLinks << " links." );
+
+  for( const auto &entity : entities( gridView, Dune::Codim< codim >() ) )
+  {
+    for( std::size_t k = 0; k < numFields; ++k )
+    {
+      if( fields[ k ][ gridView.indexSet().index( entity ) ] != idSet.id( entity ) + IdType( k ) )
+        DUNE_THROW( Dune::GridError, "Concurrent vector communications mixed up their data." );
+    }
+  }
+}
+
+
+template< class GridView >
+void checkFusedCommunication ( const GridView &gridView )
+{
+  typedef typename GridView::Grid Grid;
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+
+  const int dimension = GridView::dimension;
+  const typename Grid::GlobalIdSet &idSet = gridView.grid().globalIdSet();
+
+  // cell ids, vertex ids (twice) and vertex ids as floating point values
+  auto initialize = [ &gridView, &idSet ] ( std::vector< IdType > &cellIds, std::vector< IdType > &vertexIds, std::vector< double > &vertexValues ) {
+      cellIds.assign( gridView.size( 0 ), std::numeric_limits< IdType >::max() );
+      for( const auto &element : elements( gridView, Dune::Partitions::interiorBorder ) )
+        cellIds[ gridView.indexSet().index( element ) ] = idSet.id( element );
+
+      vertexIds.assign( 2*gridView.size( dimension ), std::numeric_limits< IdType >::max() );
+      vertexValues.assign( gridView.size( dimension ), -1.0 );
+      for( const auto &vertex : vertices( gridView, Dune::Partitions::interiorBorder ) )
+      {
+        const auto index = gridView.indexSet().index( vertex );
+        vertexIds[ 2*index ] = vertexIds[ 2*index+1 ] = idSet.id( vertex );
+        vertexValues[ index ] = double( idSet.id( vertex ) );
+      }
+    };
+
+  std::vector< IdType > cellIds, vertexIds;
+  std::vector< double > vertexValues;
+  initialize( cellIds, vertexIds, vertexValues );
+  gridView.impl().communicate( cellIds, 0, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ).wait();
+  gridView.impl().communicate( vertexIds, dimension, 2, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ).wait();
+  gridView.impl().communicate( vertexValues, dimension, Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication ).wait();
+
+  // every entity has an owner, so all entities must have received their id
+  for( const auto &element : elements( gridView ) )
+  {
+    if( cellIds[ gridView.indexSet().index( element ) ] != idSet.id( element ) )
+      DUNE_THROW( Dune::GridError, "Vector communication received wrong cell data." );
+  }
+  for( const auto &vertex : vertices( gridView ) )
+  {
+    const auto index = gridView.indexSet().index( vertex );
+    if( (vertexIds[ 2*index ] != idSet.id( vertex )) || (vertexIds[ 2*index+1 ] != idSet.id( vertex )) || (vertexValues[ index ] != double( idSet.id( vertex ) )) )
+      DUNE_THROW( Dune::GridError, "Vector communication received wrong vertex data." );
+  }
+
+  std::vector< IdType > fusedCellIds, fusedVertexIds;
+  std::vector< double > fusedVertexValues;
+  initialize( fusedCellIds, fusedVertexIds, fusedVertexValues );
+  Dune::SPFusedCommunication< typename std::remove_const< Grid >::type > communication( gridView.indexSet(), Dune::InteriorBorder_All_Interface, Dune::ForwardCommunication );
+  communication.add( fusedCellIds, 0 );
+  communication.add( fusedVertexIds, dimension, 2 );
+  communication.add( fusedVertexValues, dimension );
+  for( int i = 0; i < 2; ++i )
+    communication.exchange();
+
+  if( (fusedCellIds != cellIds) || (fusedVertexIds != vertexIds) || (fusedVertexValues != vertexValues) )
+    DUNE_THROW( Dune::GridError, "Fused and separate vector communication differ." );
+}
+
+
+template< class Grid >
+void checkPeriodicCommunication ()
+{
+  typedef typename Grid::GlobalIdSet::IdType IdType;
+  typedef typename Grid::Domain Domain;
+
+  // with few cells per process, neighbors are linked across the periodic boundary, too
+  std::vector< typename Domain::Cube > cubes( 1, typename Domain::Cube( typename Grid::GlobalVector( 0 ), typename Grid::GlobalVector( 1 ) ) );
+  const Domain domain( cubes, typename Domain::Topology( (1u << Grid::dimension) - 1u ) );
+  std::array< int, Grid::dimension > cells, overlap;
+  cells.fill( 4 );
+  overlap.fill( 1 );
+  Grid grid( domain, typename Grid::MultiIndex( cells ), typename Grid::MultiIndex( overlap ) );
+
+  if( grid.comm().rank() == 0 )
+    std::cerr << ">>> Checking neighborhood communication on periodic grid..." << std::endl;
+
+  const auto gridView = grid.leafGridView();
+  const typename Grid::GlobalIdSet &idSet = grid.globalIdSet();
+  const IdType unknown = std::numeric_limits< IdType >::max();
+
+  Dune::Hybrid::forEach( std::make_integer_sequence< int, Grid::dimension+1 >(), [ &gridView, &idSet, unknown ] ( auto codim ) {
+      for( Dune::InterfaceType iftype : { Dune::InteriorBorder_All_Interface, Dune::All_All_Interface } )
+      {
+        // the neighborhood graph must not contain multi-edges
+        const auto &interface = gridView.impl().gridLevel().commInterface( iftype );
+        for( auto it = interface.begin(); it != interface.end(); ++it )
+        {
+          if( (std::next( it ) != interface.end()) && (std::next( it )->rank() <= it->rank()) )
+            DUNE_THROW( Dune::GridError, "Communication interface " << iftype << " links rank " << it->rank() << " more than once." );
+        }
+
+        for( Dune::CommunicationDirection dir : { Dune::ForwardCommunication, Dune::BackwardCommunication } )
+        {
+          std::vector< IdType > neighborhood( gridView.size( codim ), unknown );
+          for( const auto &entity : entities( gridView, Dune::Codim< codim >(), Dune::Partitions::interiorBorder ) )
+            neighborhood[ gridView.indexSet().index( entity ) ] = idSet.id( entity );
+          std::vector< IdType > reference( neighborhood );
+
+          Dune::SPNeighborhoodCommunication< Grid, IdType > communication( gridView.indexSet(), codim, iftype, dir );
+          communication.exchange( neighborhood );
+          gridView.impl().communicate( reference, codim, iftype, dir ).wait();
+          if( neighborhood != reference )
+            DUNE_THROW( Dune::GridError, "Packed and neighborhood vector communication differ on periodic grid (interface " << iftype << ")." );
+
+          if( (iftype == Dune::InteriorBorder_All_Interface) && (dir == Dune::ForwardCommunication)
+              && (std::find( neighborhood.begin(), neighborhood.end(), unknown ) != neighborhood.end()) )
+            DUNE_THROW( Dune::GridError, "Neighborhood communication did not fill all copies on periodic grid." );
+        }
+      }
+    } );
+}
+
+
 template< class GridView >
 void checkHierarchicSearch ( const GridView &gridView )
 {
@@ -103,12 +614,25 @@ void performCheck ( Grid &grid, int maxLevel, const typename Grid::RefinementPol
 {
   static_assert( std::is_move_constructible< Grid >::value, "Grid is not move constructible." );
 
+  typedef typename Grid::template Codim< Grid::dimension >::Geometry::GlobalCoordinate GlobalVector;
+  Dune::SPLevelContainer< Grid, GlobalVector, Dune::SPLinearProlongation > vertices( grid, Grid::dimension );
+  Dune::SPLevelContainer< Grid, typename Grid::IndexType > cells( grid, 0 );
+  for( int level = 0; level <= grid.maxLevel(); ++level )
+  {
+    const auto gridView = grid.levelGridView( level );
+    for( const auto &vertex : Dune::vertices( gridView ) )
+      vertices( vertex ) = vertex.geometry().center();
+    for( const auto &element : Dune::elements( gridView ) )
+      cells( element ) = gridView.indexSet().index( element );
+  }
+
   for( int i = 0; i <= maxLevel; ++i )
   {
     if( i > 0 )
     {
       std::cerr << ">>> Refining grid globally..." << std::endl;
       grid.globalRefine( 1, policy );
+      checkLevelContainer( grid, vertices, cells );
     }
     std::cerr << ">>> Checking grid..." << std::endl;
     gridcheck( grid );
@@ -127,6 +651,24 @@ void performCheck ( Grid &grid, int maxLevel, const typename Grid::RefinementPol
     checkCommunication( grid, -1, std::cout );
 
     checkSubIndex( grid.leafGridView() );
+    checkIndexLayout( grid.leafGridView() );
+    checkInverseIndex( grid.leafGridView() );
+    checkOwnedFirst( grid.leafGridView() );
+    checkLocalIdSet( grid );
+    checkUniformGeometry( grid.leafGridView() );
+    checkVectorCommunication( grid.leafGridView() );
+    checkConcurrentCommunication( grid.leafGridView() );
+    checkFusedCommunication( grid.leafGridView() );
+
+    std::cerr << ">>> Checking traversal orders..." << std::endl;
+    checkTiledTraversal( grid.leafGridView() );
+    checkLineTraversal( grid.leafGridView() );
+    checkParallelTraversal( grid.leafGridView() );
+    checkColoredTraversal( grid.leafGridView() );
+    checkWavefrontTraversal( grid.leafGridView() );
+    checkDeepInteriorTraversal( grid.leafGridView() );
+    checkForEachEntity( grid.leafGridView() );
+    checkOrderedTraversal( grid.leafGridView() );
 
     if( grid.comm().size() <= 1 )
     {
@@ -174,6 +716,7 @@ try
   std::cout << "Isotropic grid" << std::endl;
   Dune::GridPtr< Dune::SPGrid< double, dimGrid, Dune::SPIsotropicRefinement > > isoGrid( dgfFile );
   performCheck( *isoGrid, maxLevel );
+  checkPeriodicCommunication< Dune::SPGrid< double, dimGrid, Dune::SPIsotropicRefinement > >();
 
   std::cout << std::endl;
   std::cout << "Anisotropic grid" << std::endl;
@@ -190,6 +733,11 @@ try
   Dune::GridPtr< Dune::SPGrid< double, dimGrid, Dune::SPArbitraryRefinement > > arbitraryGrid( dgfFile );
   performCheck( *arbitraryGrid, maxLevel, Dune::SPArbitraryRefinementPolicy< dimGrid >( 3 ) );
 
+  std::cout << std::endl;
+  std::cout << "Isotropic grid with 64-bit indices" << std::endl;
+  Dune::GridPtr< Dune::SPGrid< double, dimGrid, Dune::SPIsotropicRefinement, Comm, std::uint64_t > > largeGrid( dgfFile );
+  performCheck( *largeGrid, maxLevel );
+
   return 0;
 }
 catch( const Dune::Exception &e )